@@ -3,8 +3,6 @@
 #ifndef GLOBAL_VARS_
 #define GLOBAL_VARS_
 
-#include "BitmapFontClass.h"
-
 // Debug flags for console window output blocks.
 const bool DEBUG = false;
 const bool AI_DEBUG = false;
@@ -32,6 +32,13 @@ action chessAIClass::think()
 	return bestMove;
 }
 
+action chessAIClass::think(const searchLimits& limits)
+{
+	bestMove = gameStateModel->findBestMove(limits);
+
+	return bestMove;
+}
+
 void chessAIClass::signal(int origC, int origR, int destC, int destR)
 {
 	chessPiece* piece = gameStateModel->getGameState().getSquareContents(origC, origR);
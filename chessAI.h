@@ -19,6 +19,9 @@ public:
 	//	Calling think() will cause the AI to build the game tree.
 	action think();
 
+	//	Same as above, but the search runs until limits (a depth, or time on the clock) say to stop.
+	action think(const searchLimits& limits);
+
 	//	Calling signal() will alert the AI that the player has moved, and the move data is passed.
 	void signal(int origC, int origR, int destC, int destR);
 	void signal(const chessBoardClass& chessBoard, action moveData);
@@ -30,6 +33,12 @@ public:
 
 	void traverseHistory(PIN_DIR direction) { gameStateModel->traverseGameHistory(direction); }
 
+	//	Sets the size of the AI's transposition table, in megabytes.
+	void setHashSize(int sizeMB) { gameStateModel->setHashSize(sizeMB); }
+
+	//	Sets the number of threads the AI searches with.
+	void setThreadCount(int count) { gameStateModel->setThreadCount(count); }
+
 	~chessAIClass() { delete gameStateModel; }
 
 };
@@ -0,0 +1,229 @@
+#include "chessBitboard.h"
+
+slidingTable rookTable[64];
+slidingTable bishopTable[64];
+
+//	Returns the (col, row) square as a bitboard, or an empty bitboard if it is off the board.
+static constexpr bitboard bitIfOnBoard(int col, int row)
+{
+	return (col < 0 || col > 7 || row < 0 || row > 7) ? 0 : squareBit(col, row);
+}
+
+//	Fills in the geometry tables.  This only runs while compiling, to give geometry its value.
+static constexpr boardGeometry buildGeometry()
+{
+	boardGeometry tables = {};
+
+	for (int square = 0; square < 64; ++square)
+	{
+		int col = squareColumn(square), row = squareRow(square);
+
+		tables.knight[square] = bitIfOnBoard(col + 1, row + 2) | bitIfOnBoard(col + 2, row + 1)
+			| bitIfOnBoard(col + 2, row - 1) | bitIfOnBoard(col + 1, row - 2)
+			| bitIfOnBoard(col - 1, row - 2) | bitIfOnBoard(col - 2, row - 1)
+			| bitIfOnBoard(col - 2, row + 1) | bitIfOnBoard(col - 1, row + 2);
+
+		for (int dc = -1; dc <= 1; ++dc)
+			for (int dr = -1; dr <= 1; ++dr)
+				if (dc != 0 || dr != 0)
+					tables.king[square] |= bitIfOnBoard(col + dc, row + dr);
+
+		// White pawns attack upward (toward row 7), black pawns downward.
+		tables.pawn[0][square] = bitIfOnBoard(col - 1, row + 1) | bitIfOnBoard(col + 1, row + 1);
+		tables.pawn[1][square] = bitIfOnBoard(col - 1, row - 1) | bitIfOnBoard(col + 1, row - 1);
+	}
+
+	// One direction of each row, column, and diagonal; the other direction is the opposite of it.
+	const int directions[4][2] = { { 1, 0 }, { 0, 1 }, { 1, 1 }, { 1, -1 } };
+
+	for (int from = 0; from < 64; ++from)
+		for (int i = 0; i < 4; ++i)
+		{
+			// First the whole line through from, edge to edge ...
+			bitboard line = squareBit(from);
+			for (int sign = -1; sign <= 1; sign += 2)
+				for (int col = squareColumn(from) + sign * directions[i][0], row = squareRow(from) + sign * directions[i][1];
+					col >= 0 && col <= 7 && row >= 0 && row <= 7; col += sign * directions[i][0], row += sign * directions[i][1])
+					line |= squareBit(col, row);
+
+			// ... then every square on it, with the squares passed on the way there being the ones in between.
+			for (int sign = -1; sign <= 1; sign += 2)
+			{
+				bitboard passed = 0;
+				for (int col = squareColumn(from) + sign * directions[i][0], row = squareRow(from) + sign * directions[i][1];
+					col >= 0 && col <= 7 && row >= 0 && row <= 7; col += sign * directions[i][0], row += sign * directions[i][1])
+				{
+					int to = squareIndex(col, row);
+					tables.between[from][to] = passed;
+					tables.line[from][to] = line;
+					passed |= squareBit(to);
+				}
+			}
+		}
+
+	return tables;
+}
+
+constexpr boardGeometry geometry = buildGeometry();
+
+static_assert(geometry.between[squareIndex(0, 0)][squareIndex(7, 7)] == 0x0040201008040200ull, "between mask for a1-h8 is wrong");
+
+bool usePext = false;
+
+//	Every rook/bishop square gets 2^(bits in its mask) entries, for both indexing schemes.
+static bitboard rookAttackStore[102400];
+static bitboard bishopAttackStore[5248];
+
+static bool tablesReady = false;
+
+//	====== Magic Numbers ======
+/*
+	One magic per square, found offline with the usual trial-and-error search (random sparse numbers,
+	kept if no two occupancies that give different attack sets land on the same index).  Each magic
+	is used with a shift of 64 - (bits in the square's mask), so the tables are as small as the masks allow.
+*/
+static const bitboard rookMagics[64] =
+{
+	0x8080102040008000ull, 0x5440041000200048ull, 0x008020008010000Aull, 0x0200084200100420ull,
+	0x0200081020040200ull, 0x0600019002002824ull, 0x040050811008020Cull, 0x0100004881000126ull,
+	0x0005800440008020ull, 0x2882002042090880ull, 0x0002802000801004ull, 0x0240808010000800ull,
+	0x4480800800040082ull, 0x0408808004000200ull, 0x00BA0004A8020001ull, 0x1106000042040091ull,
+	0x0020208010400080ull, 0x0022060045028020ull, 0x0020008020100080ull, 0x0202020008102041ull,
+	0x0C50808008000400ull, 0x0068808002000400ull, 0x00510400C8100201ull, 0x400006000100A444ull,
+	0x483424818008400Aull, 0x8840008080200040ull, 0x0800100080802000ull, 0x0440100080800800ull,
+	0x4000080080040080ull, 0x9124040080020080ull, 0x0089000300040E00ull, 0x080001020020488Cull,
+	0x9040002040800080ull, 0x80D0002001400242ull, 0x0000401901002002ull, 0x0030220901001000ull,
+	0x0080580005003100ull, 0x0022006C0A001008ull, 0x0802301144001248ull, 0x0020010042000084ull,
+	0x4AC0400084228004ull, 0x0010004020004000ull, 0x3110004020010100ull, 0x0598100009050020ull,
+	0x4200080011010004ull, 0x0818020004008080ull, 0x02A0708102040008ull, 0x5201010080420004ull,
+	0x100B124063800100ull, 0x7808200240048980ull, 0x8800200010008080ull, 0x1099201001000900ull,
+	0x0100050010080100ull, 0x0400800200040080ull, 0x2040280190020400ull, 0x00100C0100608200ull,
+	0x0000201241088202ull, 0x1040002042801B01ull, 0x0124090010200041ull, 0x0831002004081001ull,
+	0x2003000800021005ull, 0x80010002040008C1ull, 0x0208008122081004ull, 0x4000008844002102ull
+};
+
+static const bitboard bishopMagics[64] =
+{
+	0x0020011019010028ull, 0x0122100912208000ull, 0x1498082308200080ull, 0x0004106600000000ull,
+	0x2082021000405600ull, 0x68508804C0820201ull, 0xA004140422080010ull, 0x0120402084202004ull,
+	0x0000F0101014C080ull, 0x014002300A022041ull, 0x000084080A004020ull, 0x2061949202010083ull,
+	0x0407820210050008ull, 0x00500101084008A2ull, 0x2000040404420880ull, 0x00090044041C0710ull,
+	0x0804004030841140ull, 0x002580A001240100ull, 0x2081000214090200ull, 0x0812022C01220050ull,
+	0x0602001012100010ull, 0x0003004080454024ull, 0x0000400088084800ull, 0x8000800040480850ull,
+	0x1010040110602230ull, 0x8428204002044D32ull, 0x0340240028880200ull, 0x1804080018220040ull,
+	0x0C10101041004001ull, 0x0422208008080100ull, 0x0010810610941000ull, 0x0302122002050140ull,
+	0x8304104008054400ull, 0x1000AC5003A45026ull, 0x0202402080100508ull, 0xC801042008040100ull,
+	0x00400020210A0080ull, 0x4010404200004104ull, 0x0401180120008C00ull, 0x0811450200110052ull,
+	0xB10110825000A020ull, 0x8104008405001050ull, 0x0908094050030803ull, 0x000414C204800804ull,
+	0x2000202414004042ull, 0x044001040020A100ull, 0x0008100400440082ull, 0x210101050A040102ull,
+	0x8004442420080000ull, 0x0906008421080000ull, 0x0220208048081004ull, 0x0000004084240800ull,
+	0x00080020A0864200ull, 0x40010484880E0000ull, 0x9040100440808008ull, 0x0010028089020002ull,
+	0x100082004202C000ull, 0x4049051042022000ull, 0x010100010C110400ull, 0x8200000B02208810ull,
+	0x0000001008210100ull, 0x0000180410241840ull, 0x0880100401680A01ull, 0x04021A0809040081ull
+};
+
+//	Walks each direction from square until the edge of the board or the first occupied square (which is included).
+//	This is the slow way of doing it, so it is only used to fill the tables.
+static bitboard slidingAttacks(int square, bitboard occupied, const int directions[4][2])
+{
+	bitboard attacks = 0;
+
+	for (int i = 0; i < 4; ++i)
+	{
+		int col = squareColumn(square) + directions[i][0];
+		int row = squareRow(square) + directions[i][1];
+
+		while (col >= 0 && col <= 7 && row >= 0 && row <= 7)
+		{
+			attacks |= squareBit(col, row);
+
+			if (occupied & squareBit(col, row))
+				break;
+
+			col += directions[i][0];
+			row += directions[i][1];
+		}
+	}
+
+	return attacks;
+}
+
+//	The squares whose occupancy matters for a slider on square.  The last square of each ray is left out,
+//	since the ray stops there whether it is occupied or not.
+static bitboard relevantMask(int square, const int directions[4][2])
+{
+	bitboard mask = 0;
+
+	for (int i = 0; i < 4; ++i)
+	{
+		int col = squareColumn(square) + directions[i][0];
+		int row = squareRow(square) + directions[i][1];
+
+		while (col + directions[i][0] >= 0 && col + directions[i][0] <= 7 && row + directions[i][1] >= 0 && row + directions[i][1] <= 7)
+		{
+			mask |= squareBit(col, row);
+			col += directions[i][0];
+			row += directions[i][1];
+		}
+	}
+
+	return mask;
+}
+
+#ifdef CHESS_PEXT_AVAILABLE
+//	BMI2 is checked for at run time, so the same executable still runs on processors without it.
+static bool cpuHasBmi2()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuidex(info, 7, 0);
+	return (info[1] & (1 << 8)) != 0;
+#else
+	return __builtin_cpu_supports("bmi2");
+#endif
+}
+#else
+static bool cpuHasBmi2()
+{
+	return false;
+}
+#endif
+
+//	Fills a slider's table for every square, visiting each subset of the mask with the carry-rippler trick.
+static void initSlidingTable(slidingTable table[64], bitboard* store, const bitboard magics[64], const int directions[4][2])
+{
+	for (int square = 0; square < 64; ++square)
+	{
+		slidingTable& entry = table[square];
+
+		entry.mask = relevantMask(square, directions);
+		entry.magic = magics[square];
+		entry.shift = 64 - popCount(entry.mask);
+		entry.attacks = store;
+
+		bitboard subset = 0;
+		do
+		{
+			entry.attacks[slidingIndex(entry, subset)] = slidingAttacks(square, subset, directions);
+			subset = (subset - entry.mask) & entry.mask;
+		} while (subset != 0);
+
+		store += bitboard(1) << popCount(entry.mask);
+	}
+}
+
+void initBitboardTables()
+{
+	if (tablesReady)
+		return;
+
+	static const int rookDirections[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+	static const int bishopDirections[4][2] = { { 1, 1 }, { -1, 1 }, { 1, -1 }, { -1, -1 } };
+
+	usePext = cpuHasBmi2();
+
+	initSlidingTable(rookTable, rookAttackStore, rookMagics, rookDirections);
+	initSlidingTable(bishopTable, bishopAttackStore, bishopMagics, bishopDirections);
+
+	tablesReady = true;
+}
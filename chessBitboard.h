@@ -0,0 +1,174 @@
+#pragma once
+
+#ifndef CHESS_BITBOARD_
+#define CHESS_BITBOARD_
+
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if (defined(_M_X64) || defined(__x86_64__)) && !defined(CHESS_NO_PEXT)
+#define CHESS_PEXT_AVAILABLE
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <immintrin.h>
+#endif
+#endif
+
+//	====== Bitboard Notes ======
+/*
+	A bitboard is a 64-bit integer where each bit stands for one square of the chess board.
+	Bit (row * 8 + column) stands for the square at (column, row), using the same column/row
+	numbering as the rest of the program, so bit 0 is a1 (0, 0) and bit 63 is h8 (7, 7).
+
+	chessBoardClass keeps one bitboard per color and one per piece type, plus one for all occupied
+	squares.  The set of white knights, for example, is colorBB[WHITE] & typeBB[KNIGHT].  Questions
+	like "is anything standing between these two squares?" or "how many black pawns are left?" then
+	become a couple of bitwise operations instead of a walk over the board.
+*/
+
+typedef std::uint64_t bitboard;
+
+// Converts between (column, row) board coordinates and a square index in the range 0 - 63.
+constexpr int squareIndex(int col, int row) { return row * 8 + col; }
+constexpr int squareColumn(int square) { return square & 7; }
+constexpr int squareRow(int square) { return square >> 3; }
+
+// Returns a bitboard with only the bit for (col, row) set.
+constexpr bitboard squareBit(int col, int row) { return bitboard(1) << squareIndex(col, row); }
+constexpr bitboard squareBit(int square) { return bitboard(1) << square; }
+
+// Returns the number of squares in the set.
+inline int popCount(bitboard b)
+{
+#ifdef _MSC_VER
+	return int(__popcnt64(b));
+#else
+	return __builtin_popcountll(b);
+#endif
+}
+
+// Returns the index of the lowest square in the set.  The set must not be empty.
+inline int lowestSquare(bitboard b)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward64(&index, b);
+	return int(index);
+#else
+	return __builtin_ctzll(b);
+#endif
+}
+
+// Returns the index of the highest square in the set.  The set must not be empty.
+inline int highestSquare(bitboard b)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanReverse64(&index, b);
+	return int(index);
+#else
+	return 63 - __builtin_clzll(b);
+#endif
+}
+
+// Removes the lowest square from the set and returns its index.  The set must not be empty.
+inline int popLowestSquare(bitboard& b)
+{
+	int square = lowestSquare(b);
+	b &= b - 1;
+	return square;
+}
+
+//	====== Attack Tables ======
+/*
+	Attack sets for every piece type are looked up instead of traced square by square.  Knights, kings,
+	and pawns only need one table entry per square.  Those tables, and the between and line masks, only depend
+	on the shape of the board, so the compiler works them out (see buildGeometry() in chessBitboard.cpp) and
+	they are stored in the executable ready to use.  Rooks and bishops depend on what blocks their rays,
+	so each square has a slidingTable: only the occupied squares inside its mask matter, and those are
+	turned into an index into that square's attack table.
+
+	The index comes from one of two places:
+	-	Magic bitboards:  (occupied & mask) * magic >> shift.  The magic numbers are chosen so that every
+		blocker pattern that gives a different attack set gets a different index.
+	-	PEXT:  On processors with BMI2, _pext_u64(occupied, mask) packs the masked bits together, which is
+		a perfect index without needing a magic number.  This is detected at run time by initBitboardTables().
+		Define CHESS_NO_PEXT to always use the magics (PEXT is microcoded and slow on older AMD processors).
+
+	initBitboardTables() must be called once before the rook, bishop, and queen lookups are used;
+	chessBoardClass::init() takes care of this.
+*/
+
+struct slidingTable
+{
+	bitboard mask;
+	bitboard magic;
+	bitboard* attacks;
+	int shift;
+};
+
+extern slidingTable rookTable[64];
+extern slidingTable bishopTable[64];
+
+//	The tables that only depend on the board itself.  geometry is a compile-time constant.
+struct boardGeometry
+{
+	bitboard knight[64];
+	bitboard king[64];
+	bitboard pawn[2][64];		// Indexed by [PIECE_COLOR][square].
+	bitboard between[64][64];
+	bitboard line[64][64];
+};
+
+extern const boardGeometry geometry;
+
+extern bool usePext;
+
+void initBitboardTables();
+
+#ifdef CHESS_PEXT_AVAILABLE
+//	Packs the bits of occupied that are inside mask together.  Only called once usePext is known to be set.
+inline unsigned pextIndex(bitboard occupied, bitboard mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+	return unsigned(_pext_u64(occupied, mask));
+#else
+	//	GCC and clang only allow _pext_u64() in functions compiled for BMI2, which could then not be inlined into the
+	//	move generator, so the instruction is written out instead.
+	bitboard index;
+	__asm__("pextq %2, %1, %0" : "=r"(index) : "r"(occupied), "r"(mask));
+	return unsigned(index);
+#endif
+}
+#endif
+
+inline unsigned slidingIndex(const slidingTable& table, bitboard occupied)
+{
+#ifdef CHESS_PEXT_AVAILABLE
+	if (usePext)
+		return pextIndex(occupied, table.mask);
+#endif
+
+	return unsigned(((occupied & table.mask) * table.magic) >> table.shift);
+}
+
+// Squares attacked by a slider on square, given the occupied squares.  The first blocker in each direction is included.
+inline bitboard rookAttacks(int square, bitboard occupied) { return rookTable[square].attacks[slidingIndex(rookTable[square], occupied)]; }
+inline bitboard bishopAttacks(int square, bitboard occupied) { return bishopTable[square].attacks[slidingIndex(bishopTable[square], occupied)]; }
+inline bitboard queenAttacks(int square, bitboard occupied) { return rookAttacks(square, occupied) | bishopAttacks(square, occupied); }
+
+inline bitboard knightAttacks(int square) { return geometry.knight[square]; }
+inline bitboard kingAttacks(int square) { return geometry.king[square]; }
+
+// Squares a pawn of the given color on square attacks.
+inline bitboard pawnAttacks(int color, int square) { return geometry.pawn[color][square]; }
+
+// Squares strictly between two squares on the same row, column, or diagonal.  Empty if they don't share a line.
+inline bitboard betweenSquares(int from, int to) { return geometry.between[from][to]; }
+
+// The whole row, column, or diagonal (edge to edge) through two squares.  Empty if they don't share a line.
+inline bitboard lineThrough(int from, int to) { return geometry.line[from][to]; }
+
+#endif
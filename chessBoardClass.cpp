@@ -2,6 +2,9 @@
 
 #include "chessBoardClass.h"
 #include <iostream>
+#include <algorithm>
+#include <sstream>
+#include <cctype>
 
 
 ///				To-Dos (Ordered from vital to superfluous)
@@ -119,22 +122,7 @@
 // Initializes the chess board object, setting it to the initial game state.
 void chessBoardClass::init()
 {
-// Clear piece vectors
-
-	// Black vectors
-	bPawns.clear(); bKnights.clear(); bBishops.clear();
-	bRooks.clear(); bQueens.clear(); bKing.clear();
-	// White vectors
-	wPawns.clear(); wKnights.clear(); wBishops.clear();
-	wRooks.clear(); wQueens.clear(); wKing.clear();
-
-// Populate piece vectors, sync board to vector elements.
-
-	bPawns.resize(8); bKnights.resize(5); bBishops.resize(5);
-	bRooks.resize(5); bQueens.resize(5); bKing.resize(1);
-
-	wPawns.resize(8); wKnights.resize(5); wBishops.resize(5);
-	wRooks.resize(5); wQueens.resize(5); wKing.resize(1);
+// Populate piece pools, sync board to pool elements.
 
 	// White pawns
 
@@ -233,6 +221,7 @@ void chessBoardClass::init()
 
 	// The game doesn't start in the "gameover" state
 	checkmate = false;
+	analysisStale = false;
 
 	// Set rest of board elements to NULL (4 middle rows have no pieces at start)
 	for (int row = 2; row < 6; ++row)
@@ -242,6 +231,14 @@ void chessBoardClass::init()
 	// Clear other vectors
 	checkVector.clear(); attackVector.clear(); saviorVector.clear(); escapeVector.clear();
 
+	// Set up the bitboards to match board[][], and the attack tables the board analysis uses.
+	initBitboardTables();
+	initPieceSquareScores();
+	syncBitboards();
+
+	initZobristKeys();
+	zobristKey = computeZobristKey();
+
 	//	Set AI ownership flag, which is used for pawn promotion logic to bypass console window input.
 	//	This is set to true if the chessBoardClass object is set by a copy constructor or assignment operator.
 	ownedByAI = false;
@@ -275,867 +272,399 @@ void chessBoardClass::init()
 	}
 }
 
-// Copy Constructor - performs a deep copy of the game state from the passed obj.
-chessBoardClass::chessBoardClass(const chessBoardClass& obj)
+/*
+	================================================================
+	Forsyth-Edwards Notation
+	================================================================
+*/
+
+//	Sets the board up from a FEN string:  piece placement, side to move, castling rights, en passant square, and
+//	the (ignored) move counters.  Pieces are read rank 8 first, each rank from the a-file; uppercase is white.
+//	The string is read into a chessPosition, which is only handed to setPosition() once it has been checked.
+bool chessBoardClass::loadFEN(const std::string& fen)
 {
-	///	Technically the AI only uses the assignment operator, since the copy constructor breaks things.
-	//	When the AI creates the game tree, it will use the copy constructor or the overloaded assignment op.
-	ownedByAI = true;
+	std::istringstream input(fen);
+	std::string placement, side, castling = "-", enPassant = "-";
+
+	if (!(input >> placement >> side))
+		return false;
 
-	// Set turn, useful for vector copies.
-	turn = obj.turn;
+	input >> castling >> enPassant;
 
-//	Copy black obj piece positions and create new pieces.
-//	These loops also populate saviorVector and checkVector appropriately.
+	chessPosition position;
+	for (int square = 0; square < 64; ++square)
+		position.squares[square] = chessPosition::EMPTY_SQUARE;
 
-	// Initialize the board.
-	for (int i = 0; i < 8; ++i)
-		for (int j = 0; j < 8; ++j)
-			board[i][j] = NULL;
+	const std::string pieceLetters = "pnbrqk";
+	int counts[2][6] = { { 0 } };
+	int col = 0, row = 7;
 
-	// Copy black pawns and sync to board.
-	for (int i = 0; i < obj.bPawns.size(); ++i)
+	for (std::string::size_type i = 0; i < placement.size(); ++i)
 	{
-		bPawns.push_back(obj.bPawns[i]);
-		board[bPawns.back().getColumn()][bPawns.back().getRow()] = &bPawns.back();
+		char letter = placement[i];
 
-		// Deep copy any pawns that are part of obj.saviorVector
-		if (turn == BLACK)
+		if (letter == '/')
 		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.bPawns[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&bPawns[i]);
-					break;
-				}
+			if (col != 8 || row == 0)
+				return false;
+
+			col = 0;
+			--row;
 		}
-		else // if (turn == WHITE) deep copy any pawns that are part of obj.checkVector
+		else if (letter >= '1' && letter <= '8')
 		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.bPawns[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&bPawns[i]);
-					break;
-				}
-		}
-	}
-
-	// Copy black knights and sync to board.
-	for (int i = 0; i < obj.bKnights.size(); ++i)
-	{
-		bKnights.push_back(obj.bKnights[i]);
-		board[bKnights.back().getColumn()][bKnights.back().getRow()] = &bKnights.back();
+			col += letter - '0';
 
-		if (turn == BLACK)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.bKnights[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&bKnights[i]);
-					break;
-				}
+			if (col > 8)
+				return false;
 		}
 		else
 		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.bKnights[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&bKnights[i]);
-					break;
-				}
-		}
-	}
+			size_t type = pieceLetters.find(char(tolower(letter)));
+			PIECE_COLOR color = isupper(letter) ? WHITE : BLACK;
 
-	// Copy black bishops and sync to board.
-	for (int i = 0; i < obj.bBishops.size(); ++i)
-	{
-		bBishops.push_back(obj.bBishops[i]);
-		board[bBishops.back().getColumn()][bBishops.back().getRow()] = &bBishops.back();
+			//	Pawns can't stand on the first or last rank.
+			if (type == std::string::npos || col > 7 || (type == PAWN && (row == 0 || row == 7)))
+				return false;
 
-		if (turn == BLACK)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.bBishops[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&bBishops[i]);
-					break;
-				}
-		}
-		else
-		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.bBishops[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&bBishops[i]);
-					break;
-				}
+			position.squares[squareIndex(col++, row)] = chessPosition::pieceCode(color, PIECE_TYPE(type));
+			++counts[color][type];
 		}
 	}
 
-	// Copy black rooks and sync to board.
-	for (int i = 0; i < obj.bRooks.size(); ++i)
+	if (col != 8 || row != 0 || (side != "w" && side != "b"))
+		return false;
+
+	//	Each side needs exactly one king, and no more pieces than promotions could give it, since the piece pools only
+	//	have room for that many.
+	for (int color = WHITE; color <= BLACK; ++color)
 	{
-		bRooks.push_back(obj.bRooks[i]);
-		board[bRooks.back().getColumn()][bRooks.back().getRow()] = &bRooks.back();
+		int pawns = counts[color][PAWN];
+		int total = pawns + counts[color][KING];
+
+		if (counts[color][KING] != 1 || pawns > maxPawns)
+			return false;
 
-		if (turn == BLACK)
+		for (int type = KNIGHT; type <= QUEEN; ++type)
 		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.bRooks[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&bRooks[i]);
-					break;
-				}
+			if (counts[color][type] + pawns > maxPieces)
+				return false;
+
+			total += counts[color][type];
 		}
-		else
+
+		if (total > 16)
+			return false;
+	}
+
+	position.pieceCount[WHITE] = position.pieceCount[BLACK] = 0;
+	for (int square = 0; square < 64; ++square)
+		if (position.squares[square] != chessPosition::EMPTY_SQUARE)
 		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.bRooks[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&bRooks[i]);
-					break;
-				}
+			PIECE_COLOR color = chessPosition::codeColor(position.squares[square]);
+			position.pieceList[color][position.pieceCount[color]++] = std::uint8_t(square);
 		}
-	}
 
-	// Copy black queens and sync to board.
-	for (int i = 0; i < obj.bQueens.size(); ++i)
+	position.turn = std::uint8_t((side == "w") ? WHITE : BLACK);
+
+	//	Castling rights that the king and rook on the board can't back up are dropped.
+	position.castleRights = 0;
+	for (std::string::size_type i = 0; i < castling.size() && castling != "-"; ++i)
 	{
-		bQueens.push_back(obj.bQueens[i]);
-		board[bQueens.back().getColumn()][bQueens.back().getRow()] = &bQueens.back();
+		char right = char(tolower(castling[i]));
+		PIECE_COLOR color = isupper(castling[i]) ? WHITE : BLACK;
+		int castleRow = (color == WHITE) ? 0 : 7;
+		int rookCol = (right == 'k') ? 7 : 0;
 
-		if (turn == BLACK)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.bQueens[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&bQueens[i]);
-					break;
-				}
-		}
-		else
+		if (right != 'k' && right != 'q')
+			continue;
+
+		if (position.squares[squareIndex(4, castleRow)] == chessPosition::pieceCode(color, KING) &&
+			position.squares[squareIndex(rookCol, castleRow)] == chessPosition::pieceCode(color, ROOK))
 		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.bQueens[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&bQueens[i]);
-					break;
-				}
+			if (color == WHITE)
+				position.castleRights |= (right == 'k') ? WHITE_KING_SIDE : WHITE_QUEEN_SIDE;
+			else
+				position.castleRights |= (right == 'k') ? BLACK_KING_SIDE : BLACK_QUEEN_SIDE;
 		}
 	}
 
-	// Copy black king and sync to board.
-	bKing.push_back(obj.bKing.front());
-	board[bKing.front().getColumn()][bKing.front().getRow()] = &bKing.front();
+	//	En passant:  the square only counts if a pawn of the side that just moved stands just past it.
+	PIECE_COLOR waiting = (position.turn == WHITE) ? BLACK : WHITE;
+	position.enPassantSquare = chessPosition::NO_SQUARE;
 
-	// Note:  Kings can be their own saviors, but cannot put another king in check.
-	if (turn == BLACK)
+	if (enPassant.size() == 2 && enPassant[0] >= 'a' && enPassant[0] <= 'h' && enPassant[1] == ((waiting == BLACK) ? '6' : '3'))
 	{
-		for (int j = 0; j < obj.saviorVector.size(); ++j)
-			if (&obj.bKing.front() == obj.saviorVector[j])
-			{
-				saviorVector.push_back(&bKing.front());
-				break;
-			}
-	}
+		int passedC = enPassant[0] - 'a';
+		int passedR = enPassant[1] - '1';
+		int pawnR = (waiting == BLACK) ? 4 : 3;
 
+		if (position.squares[squareIndex(passedC, pawnR)] == chessPosition::pieceCode(waiting, PAWN))
+			position.enPassantSquare = std::uint8_t(squareIndex(passedC, passedR));
+	}
 
-// Rinse and repeat for white pieces
+	initBitboardTables();
 
-	// Copy white pawns and sync to board.
-	for (int i = 0; i < obj.wPawns.size(); ++i)
-	{
-		wPawns.push_back(obj.wPawns[i]);
-		board[wPawns.back().getColumn()][wPawns.back().getRow()] = &wPawns.back();
+	//	The side that just moved can't have left its king in check.  This is tested on the parsed position, before
+	//	anything on the board is touched, so that a rejected FEN leaves the board as it was.
+	PIECE_COLOR mover = PIECE_COLOR(position.turn);
+	bitboard occupied = 0;
+	bitboard pieces[2][6] = { { 0 } };
 
-		// Deep copy any pawns that are part of obj.saviorVector
-		if (turn == WHITE)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.wPawns[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&wPawns[i]);
-					break;
-				}
-		}
-		else // if turn == "black" deep copy any pawns that are part of obj.checkVector
+	for (int square = 0; square < 64; ++square)
+		if (position.squares[square] != chessPosition::EMPTY_SQUARE)
 		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.wPawns[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&wPawns[i]);
-					break;
-				}
+			occupied |= squareBit(square);
+			pieces[chessPosition::codeColor(position.squares[square])][chessPosition::codeType(position.squares[square])] |= squareBit(square);
 		}
-	}
 
-	// Copy white knights and sync to board.
-	for (int i = 0; i < obj.wKnights.size(); ++i)
-	{
-		wKnights.push_back(obj.wKnights[i]);
-		board[wKnights.back().getColumn()][wKnights.back().getRow()] = &wKnights.back();
+	int waitingKing = lowestSquare(pieces[waiting][KING]);
+	bitboard checkers = (rookAttacks(waitingKing, occupied) & (pieces[mover][ROOK] | pieces[mover][QUEEN]))
+		| (bishopAttacks(waitingKing, occupied) & (pieces[mover][BISHOP] | pieces[mover][QUEEN]))
+		| (knightAttacks(waitingKing) & pieces[mover][KNIGHT])
+		| (kingAttacks(waitingKing) & pieces[mover][KING])
+		| (pawnAttacks(waiting, waitingKing) & pieces[mover][PAWN]);
 
-		if (turn == WHITE)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.wKnights[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&wKnights[i]);
-					break;
-				}
-		}
-		else
-		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.wKnights[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&wKnights[i]);
-					break;
-				}
-		}
-	}
+	if (checkers != 0)
+		return false;
 
-	// Copy white bishops and sync to board.
-	for (int i = 0; i < obj.wBishops.size(); ++i)
-	{
-		wBishops.push_back(obj.wBishops[i]);
-		board[wBishops.back().getColumn()][wBishops.back().getRow()] = &wBishops.back();
+	//	Only the pieces, turn, castling, and en passant are filled in; the bitboards and the rest are worked out on
+	//	the board.
+	initPieceSquareScores();
+	initZobristKeys();
 
-		if (turn == WHITE)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.wBishops[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&wBishops[i]);
-					break;
-				}
-		}
-		else
-		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.wBishops[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&wBishops[i]);
-					break;
-				}
-		}
-	}
+	setPosition(position);
+	syncBitboards();
+	zobristKey = computeZobristKey();
 
-	// Copy white rooks and sync to board.
-	for (int i = 0; i < obj.wRooks.size(); ++i)
-	{
-		wRooks.push_back(obj.wRooks[i]);
-		board[wRooks.back().getColumn()][wRooks.back().getRow()] = &wRooks.back();
+	return true;
+}
 
-		if (turn == WHITE)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.wRooks[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&wRooks[i]);
-					break;
-				}
-		}
-		else
-		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.wRooks[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&wRooks[i]);
-					break;
-				}
-		}
-	}
+//	Writes the position out as a FEN string.
+std::string chessBoardClass::toFEN()
+{
+	const char pieceLetters[] = "pnbrqk";
+	std::string fen;
 
-	// Copy white queens and sync to board.
-	for (int i = 0; i < obj.wQueens.size(); ++i)
+	for (int row = 7; row >= 0; --row)
 	{
-		wQueens.push_back(obj.wQueens[i]);
-		board[wQueens.back().getColumn()][wQueens.back().getRow()] = &wQueens.back();
+		int empty = 0;
 
-		if (turn == WHITE)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.wQueens[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&wQueens[i]);
-					break;
-				}
-		}
-		else
+		for (int col = 0; col < numColumns; ++col)
 		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.wQueens[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&wQueens[i]);
-					break;
-				}
+			chessPiece* piece = board[col][row];
+
+			if (piece == NULL)
+			{
+				++empty;
+				continue;
+			}
+
+			if (empty > 0)
+				fen += char('0' + empty);
+			empty = 0;
+
+			char letter = pieceLetters[piece->getType()];
+			fen += (piece->getColor() == WHITE) ? char(toupper(letter)) : letter;
 		}
+
+		if (empty > 0)
+			fen += char('0' + empty);
+		if (row > 0)
+			fen += '/';
 	}
 
-	// Copy white king and sync to board.
-	wKing.push_back(obj.wKing.front());
-	board[wKing.front().getColumn()][wKing.front().getRow()] = &wKing.front();
+	fen += (turn == WHITE) ? " w " : " b ";
+
+	int rights = getCastleRights();
+	if (rights & WHITE_KING_SIDE)
+		fen += 'K';
+	if (rights & WHITE_QUEEN_SIDE)
+		fen += 'Q';
+	if (rights & BLACK_KING_SIDE)
+		fen += 'k';
+	if (rights & BLACK_QUEEN_SIDE)
+		fen += 'q';
+	if (rights == 0)
+		fen += '-';
+
+	//	A pawn of the side that just moved with its enPassant flag set made a double step, passing over the square.
+	std::string enPassant = "-";
 
-	// Note:  Kings can be their own saviors, but cannot put another king in check.
 	if (turn == WHITE)
 	{
-		for (int j = 0; j < obj.saviorVector.size(); ++j)
-			if (&obj.wKing.front()== obj.saviorVector[j])
-			{
-				saviorVector.push_back(&wKing.front());
-				break;
-			}
+		for (int i = 0; i < bPawns.size(); ++i)
+			if (bPawns[i].getEnPassant() && !bPawns[i].getCaptured())
+				enPassant = std::string(1, char('a' + bPawns[i].getColumn())) + '6';
+	}
+	else
+	{
+		for (int i = 0; i < wPawns.size(); ++i)
+			if (wPawns[i].getEnPassant() && !wPawns[i].getCaptured())
+				enPassant = std::string(1, char('a' + wPawns[i].getColumn())) + '3';
 	}
 
-	// Copy escapeVector
-	for (int i = 0; i < obj.escapeVector.size(); ++i)
-		escapeVector.push_back(obj.escapeVector[i]);
-
-	// Copy attackVector
-	for (int i = 0; i < obj.attackVector.size(); ++i)
-		attackVector.push_back(obj.attackVector[i]);
+	fen += ' ' + enPassant + " 0 1";
 
-	// Probably superfluous, but what the hell!
-	checkmate = obj.checkmate;
+	return fen;
+}
 
-	// Debug message
-	/*
-	if (DEBUG)
+//	Adds a new piece to the end of its pool and puts it on the board.  The piece starts with its constructor's
+//	flags (canCastle set, enPassant clear); setPosition() corrects them afterward.
+void chessBoardClass::placePiece(PIECE_COLOR color, PIECE_TYPE type, int col, int row)
+{
+	if (color == WHITE)
 	{
-		using std::cout;
-		using std::endl;
-		cout << "==================" << endl
-			<< "copyBoard Contents" << endl
-			<< "==================" << endl;
-		for (int row = 0; row < 8; ++row)
+		switch (type)
 		{
-			using std::cout;
-			using std::endl;
-			for (int col = 0; col < 8; ++col)
-			{
-				if (board[col][row])
-					cout << "(" << col << ", " << row << ")"
-					<< " == " << board[col][row]->getColor() << " "
-					<< board[col][row]->getType() << endl;
-			}
-			cout << endl;
+		case PAWN:		wPawns.push_back(whitePawn(col, row));		board[col][row] = &wPawns.back();		break;
+		case KNIGHT:	wKnights.push_back(whiteKnight(col, row));	board[col][row] = &wKnights.back();		break;
+		case BISHOP:	wBishops.push_back(whiteBishop(col, row));	board[col][row] = &wBishops.back();		break;
+		case ROOK:		wRooks.push_back(whiteRook(col, row));		board[col][row] = &wRooks.back();		break;
+		case QUEEN:		wQueens.push_back(whiteQueen(col, row));	board[col][row] = &wQueens.back();		break;
+		case KING:		wKing.push_back(whiteKing(col, row));		board[col][row] = &wKing.back();		break;
+		}
+	}
+	else
+	{
+		switch (type)
+		{
+		case PAWN:		bPawns.push_back(blackPawn(col, row));		board[col][row] = &bPawns.back();		break;
+		case KNIGHT:	bKnights.push_back(blackKnight(col, row));	board[col][row] = &bKnights.back();		break;
+		case BISHOP:	bBishops.push_back(blackBishop(col, row));	board[col][row] = &bBishops.back();		break;
+		case ROOK:		bRooks.push_back(blackRook(col, row));		board[col][row] = &bRooks.back();		break;
+		case QUEEN:		bQueens.push_back(blackQueen(col, row));	board[col][row] = &bQueens.back();		break;
+		case KING:		bKing.push_back(blackKing(col, row));		board[col][row] = &bKing.back();		break;
 		}
-		cout << "=================" << endl;
 	}
-	*/
 }
 
-//	Overloaded Assignment Operator - essentially identical to what the copy constructor does.
-void chessBoardClass::operator=(const chessBoardClass& obj)
+// Copy Constructor - copies the game state of obj by way of a chessPosition.
+chessBoardClass::chessBoardClass(const chessBoardClass& obj)
 {
 	//	Sets the flag, which is used in pawnPromotion to bypass console window input commands.
 	ownedByAI = true;
 
-	//	Clear calling object's piece vectors.
-	bPawns.clear(); bKnights.clear(); bBishops.clear(); bRooks.clear(); bQueens.clear(); bKing.clear();
-	wPawns.clear(); wKnights.clear(); wBishops.clear(); wRooks.clear(); wQueens.clear(); wKing.clear();
+	chessPosition position;
+	obj.getPosition(position);
+	setPosition(position);
+}
 
-	//	Clear game-state data vectors.
-	checkVector.clear(); escapeVector.clear(); attackVector.clear();
-	saviorVector.clear(); pinVector.clear(); defenderVector.clear();
+//	Overloaded Assignment Operator - identical to what the copy constructor does.
+void chessBoardClass::operator=(const chessBoardClass& obj)
+{
+	//	Sets the flag, which is used in pawnPromotion to bypass console window input commands.
+	ownedByAI = true;
+
+	chessPosition position;
+	obj.getPosition(position);
+	setPosition(position);
+}
 
-	// Set turn, useful for vector copies.
-	turn = obj.turn;
+//	Writes out the position.  The piece lists come out in square order.
+void chessBoardClass::getPosition(chessPosition& position) const
+{
+	position.colorBB[WHITE] = colorBB[WHITE];
+	position.colorBB[BLACK] = colorBB[BLACK];
+	for (int i = 0; i < 6; ++i)
+		position.typeBB[i] = typeBB[i];
 
-	//	Copy black obj piece positions and create new pieces.
-	//	These loops also populate saviorVector and checkVector appropriately.
+	position.zobristKey = zobristKey;
+	position.phaseScores[MIDGAME] = std::int16_t(phaseScores[MIDGAME]);
+	position.phaseScores[ENDGAME] = std::int16_t(phaseScores[ENDGAME]);
+	position.gamePhase = std::uint8_t(gamePhase);
+	position.turn = std::uint8_t(turn);
+	position.castleRights = std::uint8_t(getCastleRights());
+	position.enPassantSquare = chessPosition::NO_SQUARE;
 
-	// Initialize the board.
-	for (int i = 0; i < 8; ++i)
-		for (int j = 0; j < 8; ++j)
-			board[i][j] = NULL;
+	position.pieceCount[WHITE] = position.pieceCount[BLACK] = 0;
 
-	// Copy black pawns and sync to board.
-	for (int i = 0; i < obj.bPawns.size(); ++i)
+	for (int square = 0; square < 64; ++square)
 	{
-		//	Don't bother copying over captured pieces.
-		if (obj.bPawns[i].getCaptured())
-			continue;
-		
-			bPawns.push_back(obj.bPawns[i]);
-		board[bPawns.back().getColumn()][bPawns.back().getRow()] = &bPawns.back();
+		chessPiece* piece = board[squareColumn(square)][squareRow(square)];
 
-		// Deep copy any pawns that are part of obj.saviorVector
-		if (turn == BLACK)
+		if (piece == NULL)
 		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.bPawns[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&bPawns.back());
-					break;
-				}
+			position.squares[square] = chessPosition::EMPTY_SQUARE;
+			continue;
+		}
 
-			for (int j = 0; j < obj.pinVector.size(); ++j)
-				if (&obj.bPawns[i] == obj.pinVector[j].first.first)
-				{
-					chessPiece* pinner = obj.pinVector[j].first.second;
-					PIN_DIR pinDirection = obj.pinVector[j].second;
-					pinVector.push_back(std::make_pair(std::make_pair(&bPawns.back(), pinner), pinDirection));
-				}
+		PIECE_COLOR color = piece->getColor();
 
-			for (auto itr = obj.defenderVector.begin(); itr != obj.defenderVector.end(); ++itr)
-				if (&obj.bPawns[i] == itr->first)
-					defenderVector.push_back(std::make_pair(&bPawns.back(), itr->second));
-		}
-		else // if (turn == WHITE) deep copy any pawns that are part of obj.checkVector
-		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.bPawns[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&bPawns.back());
-					break;
-				}
-		}
+		position.squares[square] = chessPosition::pieceCode(color, piece->getType());
+		position.pieceList[color][position.pieceCount[color]++] = std::uint8_t(square);
+
+		//	Only the pawn of the side that just moved that made a double step still has its enPassant flag set.
+		if (piece->getType() == PAWN && color != turn && getMoveFlag(*piece))
+			position.enPassantSquare = std::uint8_t(squareIndex(squareColumn(square), (color == WHITE) ? 2 : 5));
 	}
+}
 
-	// Copy black knights and sync to board.
-	for (int i = 0; i < obj.bKnights.size(); ++i)
-	{
-		if (obj.bKnights[i].getCaptured())
-			continue;
+//	Rebuilds the piece pools and board[][] from position, and takes the bitboards, key, and scores as they are.
+void chessBoardClass::setPosition(const chessPosition& position)
+{
+	bPawns.clear(); bKnights.clear(); bBishops.clear(); bRooks.clear(); bQueens.clear(); bKing.clear();
+	wPawns.clear(); wKnights.clear(); wBishops.clear(); wRooks.clear(); wQueens.clear(); wKing.clear();
+
+	checkVector.clear(); escapeVector.clear(); attackVector.clear();
+	saviorVector.clear(); pinVector.clear(); defenderVector.clear();
 
-		bKnights.push_back(obj.bKnights[i]);
-		board[bKnights.back().getColumn()][bKnights.back().getRow()] = &bKnights.back();
+	for (int col = 0; col < numColumns; ++col)
+		for (int row = 0; row < numRows; ++row)
+			board[col][row] = NULL;
 
-		if (turn == BLACK)
+	for (int color = WHITE; color <= BLACK; ++color)
+		for (int i = 0; i < position.pieceCount[color]; ++i)
 		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.bKnights[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&bKnights.back());
-					break;
-				}
+			int square = position.pieceList[color][i];
+			placePiece(PIECE_COLOR(color), chessPosition::codeType(position.squares[square]), squareColumn(square), squareRow(square));
+		}
 
-			for (int j = 0; j < obj.pinVector.size(); ++j)
-				if (&obj.bKnights[i] == obj.pinVector[j].first.first)
-				{
-					chessPiece* pinner = obj.pinVector[j].first.second;
-					PIN_DIR pinDirection = obj.pinVector[j].second;
-					pinVector.push_back(std::make_pair(std::make_pair(&bKnights.back(), pinner), pinDirection));
-				}
+	turn = PIECE_COLOR(position.turn);
 
-			for (auto itr = obj.defenderVector.begin(); itr != obj.defenderVector.end(); ++itr)
-				if (&obj.bKnights[i] == itr->first)
-					defenderVector.push_back(std::make_pair(&bKnights.back(), itr->second));
-		}
-		else
+	//	Castling:  the king and rook of each right keep their canCastle flags; every other king and rook loses it.
+	wKing.front().setCastle(false);
+	bKing.front().setCastle(false);
+	for (int i = 0; i < wRooks.size(); ++i)
+		wRooks[i].setCastle(false);
+	for (int i = 0; i < bRooks.size(); ++i)
+		bRooks[i].setCastle(false);
+
+	const int rights[4] = { WHITE_KING_SIDE, WHITE_QUEEN_SIDE, BLACK_KING_SIDE, BLACK_QUEEN_SIDE };
+
+	for (int i = 0; i < 4; ++i)
+		if (position.castleRights & rights[i])
 		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.bKnights[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&bKnights.back());
-					break;
-				}
+			int castleRow = (i < 2) ? 0 : 7;
+			int rookCol = (i % 2 == 0) ? 7 : 0;
+
+			setMoveFlag(*board[4][castleRow], true);
+			setMoveFlag(*board[rookCol][castleRow], true);
 		}
-	}
 
-	// Copy black bishops and sync to board.
-	for (int i = 0; i < obj.bBishops.size(); ++i)
+	//	En passant:  the pawn that passed over the square keeps its enPassant flag until its side's next turn, just as
+	//	if it had made the double step.
+	if (position.enPassantSquare != chessPosition::NO_SQUARE)
 	{
-		if (obj.bBishops[i].getCaptured())
-			continue;
+		int col = squareColumn(position.enPassantSquare);
+		int row = (squareRow(position.enPassantSquare) == 2) ? 3 : 4;
 
-		bBishops.push_back(obj.bBishops[i]);
-		board[bBishops.back().getColumn()][bBishops.back().getRow()] = &bBishops.back();
+		setMoveFlag(*board[col][row], true);
+	}
 
-		if (turn == BLACK)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.bBishops[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&bBishops.back());
-					break;
-				}
+	colorBB[WHITE] = position.colorBB[WHITE];
+	colorBB[BLACK] = position.colorBB[BLACK];
+	for (int i = 0; i < 6; ++i)
+		typeBB[i] = position.typeBB[i];
+	occupiedBB = colorBB[WHITE] | colorBB[BLACK];
 
-			for (int j = 0; j < obj.pinVector.size(); ++j)
-				if (&obj.bBishops[i] == obj.pinVector[j].first.first)
-				{
-					chessPiece* pinner = obj.pinVector[j].first.second;
-					PIN_DIR pinDirection = obj.pinVector[j].second;
-					pinVector.push_back(std::make_pair(std::make_pair(&bBishops.back(), pinner), pinDirection));
-				}
+	zobristKey = position.zobristKey;
+	phaseScores[MIDGAME] = position.phaseScores[MIDGAME];
+	phaseScores[ENDGAME] = position.phaseScores[ENDGAME];
+	gamePhase = position.gamePhase;
 
-			for (auto itr = obj.defenderVector.begin(); itr != obj.defenderVector.end(); ++itr)
-				if (&obj.bBishops[i] == itr->first)
-					defenderVector.push_back(std::make_pair(&bBishops.back(), itr->second));
-		}
-		else
-		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.bBishops[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&bBishops.back());
-					break;
-				}
-		}
-	}
-
-	// Copy black rooks and sync to board.
-	for (int i = 0; i < obj.bRooks.size(); ++i)
-	{
-		if (obj.bRooks[i].getCaptured())
-			continue;
-
-		bRooks.push_back(obj.bRooks[i]);
-		board[bRooks.back().getColumn()][bRooks.back().getRow()] = &bRooks.back();
-
-		if (turn == BLACK)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.bRooks[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&bRooks.back());
-					break;
-				}
-
-			for (int j = 0; j < obj.pinVector.size(); ++j)
-				if (&obj.bRooks[i] == obj.pinVector[j].first.first)
-				{
-					chessPiece* pinner = obj.pinVector[j].first.second;
-					PIN_DIR pinDirection = obj.pinVector[j].second;
-					pinVector.push_back(std::make_pair(std::make_pair(&bRooks.back(), pinner), pinDirection));
-				}
-
-			for (auto itr = obj.defenderVector.begin(); itr != obj.defenderVector.end(); ++itr)
-				if (&obj.bRooks[i] == itr->first)
-					defenderVector.push_back(std::make_pair(&bRooks.back(), itr->second));
-		}
-		else
-		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.bRooks[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&bRooks.back());
-					break;
-				}
-		}
-	}
-
-	// Copy black queens and sync to board.
-	for (int i = 0; i < obj.bQueens.size(); ++i)
-	{
-		if (obj.bQueens[i].getCaptured())
-			continue;
-
-		bQueens.push_back(obj.bQueens[i]);
-		board[bQueens.back().getColumn()][bQueens.back().getRow()] = &bQueens.back();
-
-		if (turn == BLACK)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.bQueens[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&bQueens.back());
-					break;
-				}
-
-			for (int j = 0; j < obj.pinVector.size(); ++j)
-				if (&obj.bQueens[i] == obj.pinVector[j].first.first)
-				{
-					chessPiece* pinner = obj.pinVector[j].first.second;
-					PIN_DIR pinDirection = obj.pinVector[j].second;
-					pinVector.push_back(std::make_pair(std::make_pair(&bQueens.back(), pinner), pinDirection));
-				}
-
-			for (auto itr = obj.defenderVector.begin(); itr != obj.defenderVector.end(); ++itr)
-				if (&obj.bQueens[i] == itr->first)
-					defenderVector.push_back(std::make_pair(&bQueens.back(), itr->second));
-		}
-		else
-		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.bQueens[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&bQueens.back());
-					break;
-				}
-		}
-	}
-
-	// Copy black king and sync to board.
-	bKing.push_back(obj.bKing.front());
-	board[bKing.front().getColumn()][bKing.front().getRow()] = &bKing.front();
-
-	// Note:  Kings can be their own saviors, but cannot put another king in check.
-	if (turn == BLACK)
-	{
-		for (int j = 0; j < obj.saviorVector.size(); ++j)
-			if (&obj.bKing.front() == obj.saviorVector[j])
-			{
-				saviorVector.push_back(&bKing.front());
-				break;
-			}
-	}
-
-
-	// Rinse and repeat for white pieces
-
-	// Copy white pawns and sync to board.
-	for (int i = 0; i < obj.wPawns.size(); ++i)
-	{
-		if (obj.wPawns[i].getCaptured())
-			continue;
-
-		wPawns.push_back(obj.wPawns[i]);
-		board[wPawns.back().getColumn()][wPawns.back().getRow()] = &wPawns.back();
-
-		// Deep copy any pawns that are part of obj.saviorVector
-		if (turn == WHITE)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.wPawns[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&wPawns.back());
-					break;
-				}
-
-			for (int j = 0; j < obj.pinVector.size(); ++j)
-				if (&obj.wPawns[i] == obj.pinVector[j].first.first)
-				{
-					chessPiece* pinner = obj.pinVector[j].first.second;
-					PIN_DIR pinDirection = obj.pinVector[j].second;
-					pinVector.push_back(std::make_pair(std::make_pair(&wPawns.back(), pinner), pinDirection));
-				}
-
-			for (auto itr = obj.defenderVector.begin(); itr != obj.defenderVector.end(); ++itr)
-				if (&obj.wPawns[i] == itr->first)
-					defenderVector.push_back(std::make_pair(&wPawns.back(), itr->second));
-		}
-		else // if turn == "black" deep copy any pawns that are part of obj.checkVector
-		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.wPawns[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&wPawns.back());
-					break;
-				}
-		}
-	}
-
-	// Copy white knights and sync to board.
-	for (int i = 0; i < obj.wKnights.size(); ++i)
-	{
-		if (obj.wKnights[i].getCaptured())
-			continue;
-
-		wKnights.push_back(obj.wKnights[i]);
-		board[wKnights.back().getColumn()][wKnights.back().getRow()] = &wKnights.back();
-
-		if (turn == WHITE)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.wKnights[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&wKnights.back());
-					break;
-				}
-
-			for (int j = 0; j < obj.pinVector.size(); ++j)
-				if (&obj.wKnights[i] == obj.pinVector[j].first.first)
-				{
-					chessPiece* pinner = obj.pinVector[j].first.second;
-					PIN_DIR pinDirection = obj.pinVector[j].second;
-					pinVector.push_back(std::make_pair(std::make_pair(&wKnights.back(), pinner), pinDirection));
-				}
-
-			for (auto itr = obj.defenderVector.begin(); itr != obj.defenderVector.end(); ++itr)
-				if (&obj.wKnights[i] == itr->first)
-					defenderVector.push_back(std::make_pair(&wKnights.back(), itr->second));
-		}
-		else
-		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.wKnights[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&wKnights.back());
-					break;
-				}
-		}
-	}
-
-	// Copy white bishops and sync to board.
-	for (int i = 0; i < obj.wBishops.size(); ++i)
-	{
-		if (obj.wBishops[i].getCaptured())
-			continue;
-
-		wBishops.push_back(obj.wBishops[i]);
-		board[wBishops.back().getColumn()][wBishops.back().getRow()] = &wBishops.back();
-
-		if (turn == WHITE)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.wBishops[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&wBishops.back());
-					break;
-				}
-
-			for (int j = 0; j < obj.pinVector.size(); ++j)
-				if (&obj.wBishops[i] == obj.pinVector[j].first.first)
-				{
-					chessPiece* pinner = obj.pinVector[j].first.second;
-					PIN_DIR pinDirection = obj.pinVector[j].second;
-					pinVector.push_back(std::make_pair(std::make_pair(&wBishops.back(), pinner), pinDirection));
-				}
-
-			for (auto itr = obj.defenderVector.begin(); itr != obj.defenderVector.end(); ++itr)
-				if (&obj.wBishops[i] == itr->first)
-					defenderVector.push_back(std::make_pair(&wBishops.back(), itr->second));
-		}
-		else
-		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.wBishops[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&wBishops.back());
-					break;
-				}
-		}
-	}
-
-	// Copy white rooks and sync to board.
-	for (int i = 0; i < obj.wRooks.size(); ++i)
-	{
-		if (obj.wRooks[i].getCaptured())
-			continue;
-
-		wRooks.push_back(obj.wRooks[i]);
-		board[wRooks.back().getColumn()][wRooks.back().getRow()] = &wRooks.back();
-
-		if (turn == WHITE)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.wRooks[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&wRooks.back());
-					break;
-				}
-
-			for (int j = 0; j < obj.pinVector.size(); ++j)
-				if (&obj.wRooks[i] == obj.pinVector[j].first.first)
-				{
-					chessPiece* pinner = obj.pinVector[j].first.second;
-					PIN_DIR pinDirection = obj.pinVector[j].second;
-					pinVector.push_back(std::make_pair(std::make_pair(&wRooks.back(), pinner), pinDirection));
-				}
-
-			for (auto itr = obj.defenderVector.begin(); itr != obj.defenderVector.end(); ++itr)
-				if (&obj.wRooks[i] == itr->first)
-					defenderVector.push_back(std::make_pair(&wRooks.back(), itr->second));
-		}
-		else
-		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.wRooks[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&wRooks.back());
-					break;
-				}
-		}
-	}
-
-	// Copy white queens and sync to board.
-	for (int i = 0; i < obj.wQueens.size(); ++i)
-	{
-		if (obj.wQueens[i].getCaptured())
-			continue;
-
-		wQueens.push_back(obj.wQueens[i]);
-		board[wQueens.back().getColumn()][wQueens.back().getRow()] = &wQueens.back();
-
-		if (turn == WHITE)
-		{
-			for (int j = 0; j < obj.saviorVector.size(); ++j)
-				if (&obj.wQueens[i] == obj.saviorVector[j])
-				{
-					saviorVector.push_back(&wQueens.back());
-					break;
-				}
-
-			for (int j = 0; j < obj.pinVector.size(); ++j)
-				if (&obj.wQueens[i] == obj.pinVector[j].first.first)
-				{
-					chessPiece* pinner = obj.pinVector[j].first.second;
-					PIN_DIR pinDirection = obj.pinVector[j].second;
-					pinVector.push_back(std::make_pair(std::make_pair(&wQueens.back(), pinner), pinDirection));
-				}
-
-			for (auto itr = obj.defenderVector.begin(); itr != obj.defenderVector.end(); ++itr)
-				if (&obj.wQueens[i] == itr->first)
-					defenderVector.push_back(std::make_pair(&wQueens.back(), itr->second));
-		}
-		else
-		{
-			for (int j = 0; j < obj.checkVector.size(); ++j)
-				if (&obj.wQueens[i] == obj.checkVector[j])
-				{
-					checkVector.push_back(&wQueens.back());
-					break;
-				}
-		}
-	}
-
-	// Copy white king and sync to board.
-	wKing.push_back(obj.wKing.front());
-	board[wKing.front().getColumn()][wKing.front().getRow()] = &wKing.front();
-
-	// Note:  Kings can be their own saviors, but cannot put another king in check.
-	if (turn == WHITE)
-	{
-		for (int j = 0; j < obj.saviorVector.size(); ++j)
-			if (&obj.wKing.front() == obj.saviorVector[j])
-			{
-				saviorVector.push_back(&wKing.front());
-				break;
-			}
-	}
-
-	// Copy escapeVector
-	for (int i = 0; i < obj.escapeVector.size(); ++i)
-		escapeVector.push_back(obj.escapeVector[i]);
-
-	// Copy attackVector
-	for (int i = 0; i < obj.attackVector.size(); ++i)
-		attackVector.push_back(obj.attackVector[i]);
-
-	// Probably superfluous, but what the hell!
-	checkmate = obj.checkmate;
-
-	//	This is to counteract a bug related to pawnPromotion.
-
-
-	// Debug message
-	/*
-	if (DEBUG)
-	{
-	using std::cout;
-	using std::endl;
-	cout << "==================" << endl
-	<< "copyBoard Contents" << endl
-	<< "==================" << endl;
-	for (int row = 0; row < 8; ++row)
-	{
-	using std::cout;
-	using std::endl;
-	for (int col = 0; col < 8; ++col)
-	{
-	if (board[col][row])
-	cout << "(" << col << ", " << row << ")"
-	<< " == " << board[col][row]->getColor() << " "
-	<< board[col][row]->getType() << endl;
-	}
-	cout << endl;
-	}
-	cout << "=================" << endl;
-	}
-	*/
+	checkmate = false;
+	analysisStale = true;
 }
 
 // Destructor
@@ -1168,6 +697,8 @@ void chessBoardClass::swapTurn()
 	else
 		turn = WHITE;
 
+	zobristKey ^= zobristTurnKey;
+
 	// Clear all vectors for next turn.
 	checkVector.clear();
 	pinVector.clear();
@@ -1182,6 +713,9 @@ void chessBoardClass::swapTurn()
 		{
 			whitePawn* pawn = &wPawns[i];
 			
+			if (pawn->getEnPassant() && !pawn->getCaptured())
+				zobristKey ^= zobristEnPassantKeys[squareIndex(pawn->getColumn(), pawn->getRow())];
+
 			if (pawn != NULL)
 				pawn->setEnPassant(false);
 		}
@@ -1192,6 +726,9 @@ void chessBoardClass::swapTurn()
 		{
 			blackPawn* pawn = &bPawns[i];
 
+			if (pawn->getEnPassant() && !pawn->getCaptured())
+				zobristKey ^= zobristEnPassantKeys[squareIndex(pawn->getColumn(), pawn->getRow())];
+
 			if (pawn != NULL)
 				pawn->setEnPassant(false);
 		}
@@ -1203,6 +740,14 @@ void chessBoardClass::setTurn(PIECE_COLOR c)
 {
 	turn = c;
 
+	zobristKey = computeZobristKey();
+
+	updateBoardAnalysis();
+}
+
+//	Scans the board from the point of view of the side to move, repopulating the board-analysis vectors.
+void chessBoardClass::updateBoardAnalysis()
+{
 	chessPiece* king;
 	if (turn == WHITE)
 		king = &wKing.front();
@@ -1212,6 +757,10 @@ void chessBoardClass::setTurn(PIECE_COLOR c)
 	// Populate checkVector with any pieces that are putting otherKing in check.
 	checkVector = scanForCheck(*king);
 
+	// Left over from an earlier position unless the king is in check now.
+	attackVector.clear();
+	saviorVector.clear();
+
 	// Populate escape vector with pair<int, int> board coordinates that represent
 	// squares that the king can safely move to.
 	escapeVector = scanForEscapeSquares(*king);
@@ -1235,17 +784,138 @@ void chessBoardClass::setTurn(PIECE_COLOR c)
 	// AND there are no escape squares,
 	// AND there are no savior pieces,
 	// then checkmate has occured.
-	if (checkVector.size() > 0 && escapeVector.empty() && saviorVector.empty())
-		checkmate = true;
+	checkmate = (checkVector.size() > 0 && escapeVector.empty() && saviorVector.empty());
+
+	analysisStale = false;
+}
+
+//	Returns the canCastle flag of a rook or king, or the enPassant flag of a pawn.  Other pieces have no such flag.
+bool chessBoardClass::getMoveFlag(chessPiece& piece) const
+{
+	return (piece.getType() == PAWN || piece.getType() == ROOK || piece.getType() == KING) && piece.getMoveFlag();
+}
+
+//	Sets the canCastle flag of a rook or king, or the enPassant flag of a pawn.
+void chessBoardClass::setMoveFlag(chessPiece& piece, bool flag)
+{
+	if (piece.getType() == PAWN || piece.getType() == ROOK || piece.getType() == KING)
+		piece.setMoveFlag(flag);
+}
+
+//	Sets the bit for (col, row) in the color, type, and occupancy bitboards, and adds the piece to the Zobrist key
+//	and phase scores.
+void chessBoardClass::addToBitboards(PIECE_COLOR color, PIECE_TYPE type, int col, int row)
+{
+	int square = squareIndex(col, row);
+	bitboard bit = squareBit(square);
+
+	colorBB[color] |= bit;
+	typeBB[type] |= bit;
+	occupiedBB |= bit;
+
+	zobristKey ^= zobristPieceKeys[color][type][square];
+
+	phaseScores[MIDGAME] += pieceSquareScores[MIDGAME][color][type][square];
+	phaseScores[ENDGAME] += pieceSquareScores[ENDGAME][color][type][square];
+	gamePhase += phaseWeights[type];
+}
+
+//	Clears the bit for (col, row) in the color, type, and occupancy bitboards, and takes the piece out of the Zobrist
+//	key and phase scores.
+void chessBoardClass::removeFromBitboards(PIECE_COLOR color, PIECE_TYPE type, int col, int row)
+{
+	int square = squareIndex(col, row);
+	bitboard bit = ~squareBit(square);
+
+	colorBB[color] &= bit;
+	typeBB[type] &= bit;
+	occupiedBB &= bit;
+
+	zobristKey ^= zobristPieceKeys[color][type][square];
+
+	phaseScores[MIDGAME] -= pieceSquareScores[MIDGAME][color][type][square];
+	phaseScores[ENDGAME] -= pieceSquareScores[ENDGAME][color][type][square];
+	gamePhase -= phaseWeights[type];
+}
+
+//	Rebuilds every bitboard from the pieces on board[][].
+void chessBoardClass::syncBitboards()
+{
+	colorBB[WHITE] = colorBB[BLACK] = 0;
+	for (int i = 0; i < 6; ++i)
+		typeBB[i] = 0;
+	occupiedBB = 0;
+
+	phaseScores[MIDGAME] = phaseScores[ENDGAME] = 0;
+	gamePhase = 0;
+
+	for (int col = 0; col < numColumns; ++col)
+		for (int row = 0; row < numRows; ++row)
+			if (board[col][row] != NULL)
+				addToBitboards(board[col][row]->getColor(), board[col][row]->getType(), col, row);
+}
+
+//	Returns the castling rights of both sides, as a set of CASTLE_RIGHTS bits.
+int chessBoardClass::getCastleRights() const
+{
+	int rights = 0;
+
+	for (int color = WHITE; color <= BLACK; ++color)
+	{
+		int row = (color == WHITE) ? 0 : 7;
+
+		chessPiece* king = board[4][row];
+		if (king == NULL || king->getType() != KING || king->getColor() != color || !getMoveFlag(*king))
+			continue;
+
+		chessPiece* rook = board[7][row];
+		if (rook != NULL && rook->getType() == ROOK && rook->getColor() == color && getMoveFlag(*rook))
+			rights |= (color == WHITE) ? WHITE_KING_SIDE : BLACK_KING_SIDE;
+
+		rook = board[0][row];
+		if (rook != NULL && rook->getType() == ROOK && rook->getColor() == color && getMoveFlag(*rook))
+			rights |= (color == WHITE) ? WHITE_QUEEN_SIDE : BLACK_QUEEN_SIDE;
+	}
+
+	return rights;
+}
+
+//	Works out the Zobrist key of the position from the bitboards, turn, castling rights, and en passant flags.
+positionKey chessBoardClass::computeZobristKey()
+{
+	positionKey key = 0;
+
+	for (int color = WHITE; color <= BLACK; ++color)
+		for (int type = PAWN; type <= KING; ++type)
+		{
+			bitboard pieces = colorBB[color] & typeBB[type];
+
+			while (pieces != 0)
+				key ^= zobristPieceKeys[color][type][popLowestSquare(pieces)];
+		}
+
+	if (turn == BLACK)
+		key ^= zobristTurnKey;
+
+	key ^= zobristCastleKeys[getCastleRights()];
+
+	for (int i = 0; i < wPawns.size(); ++i)
+		if (wPawns[i].getEnPassant() && !wPawns[i].getCaptured())
+			key ^= zobristEnPassantKeys[squareIndex(wPawns[i].getColumn(), wPawns[i].getRow())];
 
+	for (int i = 0; i < bPawns.size(); ++i)
+		if (bPawns[i].getEnPassant() && !bPawns[i].getCaptured())
+			key ^= zobristEnPassantKeys[squareIndex(bPawns[i].getColumn(), bPawns[i].getRow())];
+
+	return key;
 }
 
 // Function will implement pawn promotion.  If a pawn reaches the end of the board,
 // then it can be replaced with a knight, bishop, rook, or queen.
-void chessBoardClass::pawnPromotion(chessPiece& pawn)
+void chessBoardClass::pawnPromotion(chessPiece& pawn, PIECE_TYPE promotion)
 {
 	PIECE_COLOR color = pawn.getColor();
-	PIECE_TYPE type = pawn.getType();
+	PIECE_TYPE type = promotion;
 
 
 	if (!this->getAI())
@@ -1272,7 +942,7 @@ void chessBoardClass::pawnPromotion(chessPiece& pawn)
 		}
 	}
 
-	if (this->getAI())
+	if (this->getAI() && type == PAWN)
 		type = QUEEN;
 
 	int col = pawn.getColumn();
@@ -1281,10 +951,14 @@ void chessBoardClass::pawnPromotion(chessPiece& pawn)
 	// Get board ready to point at newly created piece.
 	board[col][row] = NULL;
 
+	// Swap the pawn for the new piece on the bitboards.
+	removeFromBitboards(color, PAWN, col, row);
+	addToBitboards(color, type, col, row);
+
 	/*
 	The conditional blocks below will create the appropriate piece, with the right type and color.
-	The piece will be pushed back onto the appropriate vector and the board will be set to point to
-	this newly created piece.
+	The piece will be pushed back onto the appropriate pool and the board will be set to point to
+	this newly created piece.  Pools never move their pieces, so every other pointer into them stays good.
 	*/
 
 	// Black piece promotion
@@ -1343,52 +1017,7 @@ void chessBoardClass::pawnPromotion(chessPiece& pawn)
 			board[col][row] = &wQueens.back();
 		}
 	}
-
-	//	There's been a recurring issue with the board losing track of pieces upon promotion, which I believe to be caused by the vector containers
-	//	allocating additional space elsewhere to store the newly pushed-back pieces.  This will readjust the board to point to the pieces in the vectors.
-	if (color == WHITE)
-	{
-		switch (type)
-		{
-		case KNIGHT:
-			for (auto itr = wKnights.begin(); itr != wKnights.end(); ++itr)
-				board[(*itr).getColumn()][(*itr).getRow()] = &(*itr);
-			break;
-		case BISHOP:
-			for (auto itr = wBishops.begin(); itr != wBishops.end(); ++itr)
-				board[(*itr).getColumn()][(*itr).getRow()] = &(*itr);
-			break;
-		case ROOK:
-			for (auto itr = wRooks.begin(); itr != wRooks.end(); ++itr)
-				board[(*itr).getColumn()][(*itr).getRow()] = &(*itr);
-			break;
-		case QUEEN:
-			for (auto itr = wQueens.begin(); itr != wQueens.end(); ++itr)
-				board[(*itr).getColumn()][(*itr).getRow()] = &(*itr);
-		}
-	}
-	else if (color == BLACK)
-	{
-		switch (type)
-		{
-		case KNIGHT:
-			for (auto itr = bKnights.begin(); itr != bKnights.end(); ++itr)
-				board[(*itr).getColumn()][(*itr).getRow()] = &(*itr);
-			break;
-		case BISHOP:
-			for (auto itr = bBishops.begin(); itr != bBishops.end(); ++itr)
-				board[(*itr).getColumn()][(*itr).getRow()] = &(*itr);
-			break;
-		case ROOK:
-			for (auto itr = bRooks.begin(); itr != bRooks.end(); ++itr)
-				board[(*itr).getColumn()][(*itr).getRow()] = &(*itr);
-			break;
-		case QUEEN:
-			for (auto itr = bQueens.begin(); itr != bQueens.end(); ++itr)
-				board[(*itr).getColumn()][(*itr).getRow()] = &(*itr);
-		}
-	}
-}
+}
 
 // Function will return a vector of pointer-to-chessPiece elements, which contains
 // all of the pieces that are currently checking the king.
@@ -1418,170 +1047,36 @@ std::vector<std::pair<std::pair<chessPiece*, chessPiece*>, PIN_DIR>> chessBoardC
 		return pinVector;
 
 	PIECE_COLOR friendly = king.getColor();
+	PIECE_COLOR enemy = (friendly == WHITE) ? BLACK : WHITE;
+	int kingSquare = squareIndex(king.getColumn(), king.getRow());
 
-	// Go through each potentially pinned piece and assess if the piece is indeed pinned.
 	// Horizontal and vertical pins come from enemy queens or rooks.
 	// Diagonal pins come from enemy queens or bishops.
 	// Pawns, knights, and kings cannot pin pieces.
-	for (int i = 0; i < pinCandidates.size(); ++i)
-	{
-		chessPiece* defender = pinCandidates[i].first;
-		PIN_DIR pinDirection = pinCandidates[i].second;
-
-		int col = defender->getColumn();
-		int row = defender->getRow();
-
-		// Switch control structure ensures the correct scan is made for the current defender.
-		switch (pinDirection)
-		{
-		case RIGHT:	// Scan for enemy to the right of the defender.
-			for (int tracerC = col + 1; tracerC <= 7; ++tracerC)
-			{
-				chessPiece* occupier = getSquareContents(tracerC, row);
-
-				if (occupier != NULL)
-				{
-					if (occupier->getColor() != friendly)
-					{
-						if (occupier->getType() == ROOK || occupier->getType() == QUEEN)
-							pinVector.push_back(std::make_pair(std::make_pair(defender, occupier), pinDirection));
-						// Bit of a "mouth-full" here, but its essentially a ( (chessPiece, chessPiece), pinDirection )
-						// pair that is pushed to the back of pinVector.  The first element of the "outer" pair just 
-						// happens to be a pair of elements itself.
-					}
-
-					break;
-				}
-			}
-			break;
-
-		case UP_RIGHT:	// Scan for enemy to the up-right of the defender.
-			for (int tracerC = col + 1, tracerR = row + 1; tracerC <= 7 && tracerR <= 7; ++tracerC, ++tracerR)
-			{
-				chessPiece* occupier = getSquareContents(tracerC, tracerR);
-
-				if (occupier != NULL)
-				{
-					if (occupier->getColor() != friendly)
-					{
-						if (occupier->getType() == BISHOP || occupier->getType() == QUEEN)
-							pinVector.push_back(std::make_pair(std::make_pair(defender, occupier), pinDirection));
-					}
-
-					break;
-				}
-			}
-			break;
-
-		case UP:	// Scan for enemy above the defender.
-			for (int tracerR = row + 1; tracerR <= 7; ++tracerR)
-			{
-				chessPiece* occupier = getSquareContents(col, tracerR);
-
-				if (occupier != NULL)
-				{
-					if (occupier->getColor() != friendly)
-					{
-						if (occupier->getType() == ROOK || occupier->getType() == QUEEN)
-							pinVector.push_back(std::make_pair(std::make_pair(defender, occupier), pinDirection));
-					}
-
-					break;
-				}
-			}
-			break;
-
-		case UP_LEFT:	// Scan for enemy to the up-left of the defender.
-			for (int tracerC = col - 1, tracerR = row + 1; tracerC >= 0 && tracerR <= 7; --tracerC, ++tracerR)
-			{
-				chessPiece* occupier = getSquareContents(tracerC, tracerR);
-
-				if (occupier != NULL)
-				{
-					if (occupier->getColor() != friendly)
-					{
-						if (occupier->getType() == BISHOP || occupier->getType() == QUEEN)
-							pinVector.push_back(std::make_pair(std::make_pair(defender, occupier), pinDirection));
-					}
-
-					break;
-				}
-			}
-			break;
-
-		case LEFT:	// Scan for enemy to the left of the defender.
-			for (int tracerC = col - 1; tracerC >= 0; --tracerC)
-			{
-				chessPiece* occupier = getSquareContents(tracerC, row);
-
-				if (occupier != NULL)
-				{
-					if (occupier->getColor() != friendly)
-					{
-						if (occupier->getType() == ROOK || occupier->getType() == QUEEN)
-							pinVector.push_back(std::make_pair(std::make_pair(defender, occupier), pinDirection));
-					}
-
-					break;
-				}
-			}
-			break;
-
-		case DOWN_LEFT:	// Scan for enemy to the down-left of the defender.
-			for (int tracerC = col - 1, tracerR = row - 1; tracerC >= 0 && tracerR >= 0; --tracerC, --tracerR)
-			{
-				chessPiece* occupier = getSquareContents(tracerC, tracerR);
-
-				if (occupier != NULL)
-				{
-					if (occupier->getColor() != friendly)
-					{
-						if (occupier->getType() == BISHOP || occupier->getType() == QUEEN)
-							pinVector.push_back(std::make_pair(std::make_pair(defender, occupier), pinDirection));
-					}
-
-					break;
-				}
-			}
-			break;
-
-		case DOWN:	// Scan for enemy below the defender.
-			for (int tracerR = row - 1; tracerR >= 0; --tracerR)
-			{
-				chessPiece* occupier = getSquareContents(col, tracerR);
-
-				if (occupier != NULL)
-				{
-					if (occupier->getColor() != friendly)
-					{
-						if (occupier->getType() == ROOK || occupier->getType() == QUEEN)
-							pinVector.push_back(std::make_pair(std::make_pair(defender, occupier), pinDirection));
-					}
-
-					break;
-				}
-			}
-			break;
+	// These are the enemy sliders that would be attacking the king on an empty board.
+	bitboard pinners = (rookAttacks(kingSquare, 0) & (typeBB[ROOK] | typeBB[QUEEN]))
+		| (bishopAttacks(kingSquare, 0) & (typeBB[BISHOP] | typeBB[QUEEN]));
+	pinners &= colorBB[enemy];
 
-		case DOWN_RIGHT:	// Scan for enemy to the down-right of the defender.
-			for (int tracerC = col + 1, tracerR = row - 1; tracerC <= 7 && tracerR >= 0; ++tracerC, --tracerR)
-			{
-				chessPiece* occupier = getSquareContents(tracerC, tracerR);
+	// A slider pins a piece if that piece is the only thing standing between it and the king.
+	// The only piece in between has to be a defender, since the defenders are the first piece in each direction.
+	while (pinners != 0)
+	{
+		int pinnerSquare = popLowestSquare(pinners);
+		bitboard blockers = betweenSquares(kingSquare, pinnerSquare) & occupiedBB;
 
-				if (occupier != NULL)
-				{
-					if (occupier->getColor() != friendly)
-					{
-						if (occupier->getType() == BISHOP || occupier->getType() == QUEEN)
-							pinVector.push_back(std::make_pair(std::make_pair(defender, occupier), pinDirection));
-					}
+		if (popCount(blockers) != 1 || !(blockers & colorBB[friendly]))
+			continue;
 
-					break;
-				}
-			}
-			break;
-		}
+		int defenderSquare = lowestSquare(blockers);
+		chessPiece* defender = board[squareColumn(defenderSquare)][squareRow(defenderSquare)];
+		chessPiece* occupier = board[squareColumn(pinnerSquare)][squareRow(pinnerSquare)];
 
+		// Bit of a "mouth-full" here, but its essentially a ( (chessPiece, chessPiece), pinDirection )
+		// pair that is pushed to the back of pinVector.  The first element of the "outer" pair just 
+		// happens to be a pair of elements itself.
+		pinVector.push_back(std::make_pair(std::make_pair(defender, occupier), 
+			pinDirection(king.getColumn(), king.getRow(), squareColumn(defenderSquare), squareRow(defenderSquare))));
 	}
 
 	// All pinned pieces are now in pinVector.
@@ -1602,156 +1097,16 @@ std::vector<std::pair<chessPiece*, PIN_DIR>> chessBoardClass::scanForDefenders(c
 	// their position relative to the king.
 	std::vector<std::pair<chessPiece*, PIN_DIR>> defenders;
 
-	// Value will reflect defender's position relative to the king's position.
-	PIN_DIR defensivePosition;
-
-	/*
-	Eight-Directional Scan For Defenders
-	- First friendly piece encountered in each direction is a defender -
-	*/
-
-	// Right Scan - Scan King's row to the right for a defender.
-	defensivePosition = RIGHT;
-	for (int tracerC = col + 1; tracerC <= 7; ++tracerC)
-	{
-		chessPiece* occupier = getSquareContents(tracerC, row);
-
-		if (occupier != NULL)
-		{
-			// Occupier is friendly - a defender.
-			if (occupier->getColor() == friendly)
-				defenders.push_back(std::make_pair(occupier, defensivePosition));
-			else // Occupier is an enemy - no defenders are present in this direction.
-				break;
-
-			break;
-		}
-	}
-
-	// Up-Right Scan - Scan King's diagonal to the up-right for a defender.
-	defensivePosition = UP_RIGHT;
-	for (int tracerC = col + 1, tracerR = row + 1; tracerC <= 7 && tracerR <= 7; ++tracerC, ++tracerR)
-	{
-		chessPiece* occupier = getSquareContents(tracerC, tracerR);
-
-		if (occupier != NULL)
-		{
-			// Occupier is friendly - a defender.
-			if (occupier->getColor() == friendly)
-				defenders.push_back(std::make_pair(occupier, defensivePosition));
-			else // Occupier is an enemy - no defenders are present in this direction.
-				break;
-
-			break;
-		}
-	}
-
-	// Up Scan - Scan King's column upward for a defender.
-	defensivePosition = UP;
-	for (int tracerR = row + 1; tracerR <= 7; ++tracerR)
-	{
-		chessPiece* occupier = getSquareContents(col, tracerR);
-
-		if (occupier != NULL)
-		{
-			// Occupier is friendly - a defender.
-			if (occupier->getColor() == friendly)
-				defenders.push_back(std::make_pair(occupier, defensivePosition));
-			else // Occupier is an enemy - no defenders are present in this direction.
-				break;
-
-			break;
-		}
-	}
-
-	// Up-Left Scan - Scan King's diagonal to the up-left for a defender.
-	defensivePosition = UP_LEFT;
-	for (int tracerC = col - 1, tracerR = row + 1; tracerC >= 0 && tracerR <= 7; --tracerC, ++tracerR)
-	{
-		chessPiece* occupier = getSquareContents(tracerC, tracerR);
-
-		if (occupier != NULL)
-		{
-			// Occupier is friendly - a defender.
-			if (occupier->getColor() == friendly)
-				defenders.push_back(std::make_pair(occupier, defensivePosition));
-			else // Occupier is an enemy - no defenders are present in this direction.
-				break;
-
-			break;
-		}
-	}
-
-	// Left Scan - Scan King's row to the left for a defender.
-	defensivePosition = LEFT;
-	for (int tracerC = col - 1; tracerC >= 0; --tracerC)
-	{
-		chessPiece* occupier = getSquareContents(tracerC, row);
-
-		if (occupier != NULL)
-		{
-			// Occupier is friendly - a defender.
-			if (occupier->getColor() == friendly)
-				defenders.push_back(std::make_pair(occupier, defensivePosition));
-			else // Occupier is an enemy - no defenders are present in this direction.
-				break;
-
-			break;
-		}
-	}
-
-	// Down-Left Scan - Scan King's diagonal to the down-left for a defender.
-	defensivePosition = DOWN_LEFT;
-	for (int tracerC = col - 1, tracerR = row - 1; tracerC >= 0 && tracerR >= 0; --tracerC, --tracerR)
-	{
-		chessPiece* occupier = getSquareContents(tracerC, tracerR);
-
-		if (occupier != NULL)
-		{
-			// Occupier is friendly - a defender.
-			if (occupier->getColor() == friendly)
-				defenders.push_back(std::make_pair(occupier, defensivePosition));
-			else // Occupier is an enemy - no defenders are present in this direction.
-				break;
-
-			break;
-		}
-	}
-
-	// Down Scan - Scan King's column downward for a defender.
-	defensivePosition = DOWN;
-	for (int tracerR = row - 1; tracerR >= 0; --tracerR)
-	{
-		chessPiece* occupier = getSquareContents(col, tracerR);
-
-		if (occupier != NULL)
-		{
-			// Occupier is friendly - a defender.
-			if (occupier->getColor() == friendly)
-				defenders.push_back(std::make_pair(occupier, defensivePosition));
-			else // Occupier is an enemy - no defenders are present in this direction.
-				break;
-
-			break;
-		}
-	}
+	// A queen on the king's square would see the first piece in each of the eight directions.
+	// The friendly ones are the defenders.
+	bitboard seen = queenAttacks(squareIndex(col, row), occupiedBB) & colorBB[friendly];
 
-	// Down-Right Scan - Scan King's diagonal to the down-right for a defender.
-	defensivePosition = DOWN_RIGHT;
-	for (int tracerC = col + 1, tracerR = row - 1; tracerC <= 7 && tracerR >= 0; ++tracerC, --tracerR)
+	while (seen != 0)
 	{
-		chessPiece* occupier = getSquareContents(tracerC, tracerR);
-
-		if (occupier != NULL)
-		{
-			// Occupier is friendly - a defender.
-			if (occupier->getColor() == friendly)
-				defenders.push_back(std::make_pair(occupier, defensivePosition));
-			else // Occupier is an enemy - no defenders are present in this direction.
-				break;
+		int square = popLowestSquare(seen);
+		int tracerC = squareColumn(square), tracerR = squareRow(square);
 
-			break;
-		}
+		defenders.push_back(std::make_pair(board[tracerC][tracerR], pinDirection(col, row, tracerC, tracerR)));
 	}
 
 	// Scans complete - assign to object's defenderVector and return vector.
@@ -1766,8 +1121,7 @@ std::vector<std::pair<chessPiece*, PIN_DIR>> chessBoardClass::scanForDefenders(c
 // and an attacking (checking) piece, as well as the square of the attacker itself.
 std::vector<std::pair<int, int>> chessBoardClass::setAttackVector(chessPiece& king)
 {
-	int kingCol = king.getColumn();
-	int kingRow = king.getRow();
+	int kingSquare = squareIndex(king.getColumn(), king.getRow());
 
 	// Will hold all of the coordinates involved in a check.
 	std::vector<std::pair<int, int>> coordinateVector;
@@ -1782,51 +1136,16 @@ std::vector<std::pair<int, int>> chessBoardClass::setAttackVector(chessPiece& ki
 		// Add the attacker's coordinates to coordinateVector
 		coordinateVector.push_back(std::make_pair(attackerCol, attackerRow));
 
-		if (kingCol == attackerCol) // If king and attacker are on the same column, it is a vertical attack
-		{
-			// King is above the attacker
-			if (kingRow > attackerRow)
-				for (int tracerR = kingRow - 1; tracerR != attackerRow; --tracerR)
-					coordinateVector.push_back(std::make_pair(attackerCol, tracerR));
-			else // King is below the attacker.
-				for (int tracerR = kingRow + 1; tracerR != attackerRow; ++tracerR)
-					coordinateVector.push_back(std::make_pair(attackerCol, tracerR));
-		}
-		else if (kingRow == attackerRow) // If king and attacker are on the same row, it is a horizontal attack
-		{
-			// King is to the right of the attacker
-			if (kingCol > attackerCol)
-				for (int tracerC = kingCol - 1; tracerC != attackerCol; --tracerC)
-					coordinateVector.push_back(std::make_pair(tracerC, attackerRow));
-			else // King is to the left of the attacker
-				for (int tracerC = kingCol + 1; tracerC != attackerCol; ++tracerC)
-					coordinateVector.push_back(std::make_pair(tracerC, attackerRow));
-		}
-		else if (abs(kingCol - attackerCol) == abs(kingRow - attackerRow))	// Diagonal attack case
+		// Then the squares in between, starting next to the king.  A knight's or pawn's check has none, and
+		// cannot be blocked.
+		bitboard between = betweenSquares(kingSquare, squareIndex(attackerCol, attackerRow));
+		bool outward = squareIndex(attackerCol, attackerRow) > kingSquare;
+		while (between)
 		{
+			int square = outward ? lowestSquare(between) : highestSquare(between);
+			between &= ~squareBit(square);
 
-			if (kingCol < attackerCol) // King is to the left of the attacker
-			{
-				if (kingRow < attackerRow) // King is to the left and below the attacker
-					for (int tracerC = kingCol + 1, tracerR = kingRow + 1; tracerC != attackerCol && tracerR != attackerRow; ++tracerC, ++tracerR)
-						coordinateVector.push_back(std::make_pair(tracerC, tracerR));
-				else if (kingRow > attackerRow) // King is to the left and above the attacker
-					for (int tracerC = kingCol + 1, tracerR = kingRow - 1; tracerC != attackerCol && tracerR != attackerRow; ++tracerC, --tracerR)
-						coordinateVector.push_back(std::make_pair(tracerC, tracerR));
-			}
-			else if (kingCol > attackerCol) // King is to the right of the attacker
-			{
-				if (kingRow < attackerRow) // King is to the right and below the attacker
-					for (int tracerC = kingCol - 1, tracerR = kingRow + 1; tracerC != attackerCol && tracerR != attackerRow; --tracerC, ++tracerR)
-						coordinateVector.push_back(std::make_pair(tracerC, tracerR));
-				else if (kingRow > attackerRow) // King is to the right and above the attacker
-					for (int tracerC = kingCol - 1, tracerR = kingRow - 1; tracerC != attackerCol && tracerR != attackerRow; --tracerC, --tracerR)
-						coordinateVector.push_back(std::make_pair(tracerC, tracerR));
-			}
-		}
-		else // Only other attack case is a knight, which cannot be blocked.
-		{
-			continue;
+			coordinateVector.push_back(std::make_pair(squareColumn(square), squareRow(square)));
 		}
 	}
 
@@ -2158,9 +1477,6 @@ std::vector<chessPiece*> chessBoardClass::scanForSaviors()
 // pieces that are the opposite of the current turn color
 std::vector<chessPiece*> chessBoardClass::getAttackers(int col, int row)
 {
-	std::vector<chessPiece*> attackers;
-
-	PIECE_COLOR friendlyColor = turn;
 	PIECE_COLOR enemyColor;
 
 	if (turn == WHITE)
@@ -2168,988 +1484,1033 @@ std::vector<chessPiece*> chessBoardClass::getAttackers(int col, int row)
 	else
 		enemyColor = WHITE;
 
-	chessPiece* scanner;
-	PIECE_COLOR color;
-	PIECE_TYPE type;
-
-	/*
-	=================
-	Horizontal Attack
-	=================
-	Threats:  Queen, Rook, or King
-	*/
+	return getPiecesOn(attackersTo(squareIndex(col, row), enemyColor, occupiedBB));
+}
 
-	// Horizontal Scan Left
-	for (int tracerC = col - 1; tracerC >= 0; --tracerC)
-	{
-		scanner = getSquareContents(tracerC, row);
+// Function will return a vector of pair<int, int> elements that are squares in proximity
+// to the king that it may move to escape check.
+std::vector<std::pair<int, int>> chessBoardClass::scanForEscapeSquares(chessPiece& king)
+{
+	int kingCol = king.getColumn();
+	int kingRow = king.getRow();
 
-		if (scanner == NULL)
-			continue;
-		else
-		{
-			color = scanner->getColor();
-			type = scanner->getType();
+	std::vector<std::pair<int, int>> coordinateVector;
 
-			if (color == enemyColor)
-				if (type == QUEEN || type == ROOK || (type == KING && tracerC == col - 1))
-					attackers.push_back(scanner);
+	chessPiece* occupier;
 
-			break;
-		}
-	}
-	// Horizontal Scan Right
-	for (int tracerC = col + 1; tracerC <= 7; ++tracerC)
+	// Scan through the 8 squares adjacent to the king, storing the
+	// coordinates to squares that the king can move to to escape check.
+	for (int tracerC = kingCol - 1; (tracerC <= kingCol + 1) && (tracerC <= 7); ++tracerC)
 	{
-		scanner = getSquareContents(tracerC, row);
-
-		if (scanner == NULL)
+		if (tracerC < 0)	// Don't start the scan out of bounds.
 			continue;
-		else
+
+		for (int tracerR = kingRow - 1; (tracerR <= kingRow + 1) && (tracerR <= 7); ++tracerR)
 		{
-			color = scanner->getColor();
-			type = scanner->getType();
+			if (tracerR < 0)	// Don't start the scan out of bounds.
+				continue;
 
-			if (color == enemyColor)
-				if (type == QUEEN || type == ROOK || (type == KING && tracerC == col + 1))
-					attackers.push_back(scanner);
+			// Check to see if square is currently occupied.
+			occupier = getSquareContents(tracerC, tracerR);
 
-			break;
+			if (occupier != NULL)
+			{
+				if (occupier->getColor() == king.getColor())	// Square is currently occupied by friendly piece.
+					continue;
+				else if (occupier->getColor() != king.getColor())	// Square is occupied by an enemy piece.
+				{
+					std::vector<chessPiece*> attackers = getAttackers(&king, tracerC, tracerR);
+					if (attackers.size() == 0)
+						coordinateVector.push_back(std::make_pair(tracerC, tracerR));	// If enemy is undefended, it's a safe square to take.
+					else
+						continue;	// If enemy is defended, then square can't be taken.
+				}
+			}
+			else if (occupier == NULL)
+			{
+				std::vector<chessPiece*> attackers = getAttackers(&king, tracerC, tracerR);
+				if (attackers.size() == 0)
+					coordinateVector.push_back(std::make_pair(tracerC, tracerR));	// Square is unoccupied and not under attack
+				else
+					continue;	// Square is unoccupied, but under attack (not safe).
+			}
 		}
 	}
 
-	/*
-	===============
-	Vertical Attack
-	===============
-	Threats:  Queen, Rook, or King
-	*/
+	return coordinateVector;
+}
 
-	// Vertical Scan Down
-	for (int tracerR = row - 1; tracerR >= 0; --tracerR)
-	{
-		scanner = getSquareContents(col, tracerR);
+//	Specially designed for use in the scanForEscapeSquares method, to test if a square is safe under non-check king movement.
+//	The issue:  The reason why this function is necessary is due to the fact that the original version has a significant oversight.
+//				The oversight is that it the other getAttackers method fails to take into account that the king is in the way during
+//				the eight-directional scanForEscapeSquares scan, so it won't detect bishops, rooks, and queens if the conditions are right.
+//	The solution:	Leave the king's square out of the occupied squares that block the sliders.
+std::vector<chessPiece*> chessBoardClass::getAttackers(chessPiece* king, int col, int row)
+{
+	PIECE_COLOR enemyColor;
 
-		if (scanner == NULL)
-			continue;
-		else
-		{
-			color = scanner->getColor();
-			type = scanner->getType();
+	if (turn == WHITE)
+		enemyColor = BLACK;
+	else
+		enemyColor = WHITE;
 
-			if (color == enemyColor)
-				if (type == QUEEN || type == ROOK || (type == KING && tracerR == row - 1))
-					attackers.push_back(scanner);
+	bitboard occupied = occupiedBB & ~squareBit(king->getColumn(), king->getRow());
 
-			break;
-		}
-	}
-	// Vertical Scan Up
-	for (int tracerR = row + 1; tracerR <= 7; ++tracerR)
-	{
-		scanner = getSquareContents(col, tracerR);
+	return getPiecesOn(attackersTo(squareIndex(col, row), enemyColor, occupied));
+}
 
-		if (scanner == NULL)
-			continue;
-		else
-		{
-			color = scanner->getColor();
-			type = scanner->getType();
+//	Returns the squares of the pieces of the given color that attack square.  Sliders are blocked by the pieces in occupied.
+bitboard chessBoardClass::attackersTo(int square, PIECE_COLOR color, bitboard occupied)
+{
+	PIECE_COLOR otherColor = (color == WHITE) ? BLACK : WHITE;
 
-			if (color == enemyColor)
-				if (type == QUEEN || type == ROOK || (type == KING && tracerR == row + 1))
-					attackers.push_back(scanner);
+	// Attacks are symmetric:  a knight on square would attack the same squares a knight attacking square could be on.
+	// Pawns are the exception, so the pawn attacks of the other color are used.
+	bitboard attackers = (rookAttacks(square, occupied) & (typeBB[ROOK] | typeBB[QUEEN]))
+		| (bishopAttacks(square, occupied) & (typeBB[BISHOP] | typeBB[QUEEN]))
+		| (knightAttacks(square) & typeBB[KNIGHT])
+		| (kingAttacks(square) & typeBB[KING])
+		| (pawnAttacks(otherColor, square) & typeBB[PAWN]);
 
-			break;
-		}
+	return attackers & colorBB[color];
+}
+
+//	Returns the pieces standing on the squares in the set.
+std::vector<chessPiece*> chessBoardClass::getPiecesOn(bitboard squares)
+{
+	std::vector<chessPiece*> pieces;
+
+	while (squares != 0)
+	{
+		int square = popLowestSquare(squares);
+		pieces.push_back(board[squareColumn(square)][squareRow(square)]);
 	}
 
-	/*
-	===============
-	Diagonal Attack
-	===============
-	Threats:  Queen, Bishop, Pawn, or King
-	*/
+	return pieces;
+}
 
-	// Diagonal Scan Up-Right
-	for (int tracerC = col + 1, tracerR = row + 1; tracerC <= 7 && tracerR <= 7; ++tracerC, ++tracerR)
+//	Returns the direction of (col, row) as seen from (originC, originR).  The squares must share a row, column, or diagonal.
+PIN_DIR chessBoardClass::pinDirection(int originC, int originR, int col, int row)
+{
+	// Indexed by [column step + 1][row step + 1].  The middle entry is never used.
+	static const PIN_DIR directions[3][3] =
 	{
-		scanner = getSquareContents(tracerC, tracerR);
+		{ DOWN_LEFT, LEFT, UP_LEFT },
+		{ DOWN, RIGHT, UP },
+		{ DOWN_RIGHT, RIGHT, UP_RIGHT }
+	};
 
-		if (scanner == NULL)
-			continue;
-		else
-		{
-			color = scanner->getColor();
-			type = scanner->getType();
+	int stepC = (col > originC) - (col < originC);
+	int stepR = (row > originR) - (row < originR);
 
-			if (color == enemyColor)						// Make sure pawn is within attack range to register a check
-				if (type == QUEEN || type == BISHOP || ((type == PAWN && tracerC == col + 1 && tracerR == row + 1)) || (type == KING && tracerC == col + 1 && tracerR == row + 1))
-					if (type == PAWN && color == WHITE)
-						break;
-					else
-						attackers.push_back(scanner);
+	return directions[stepC + 1][stepR + 1];
+}
 
-			break;
-		}
-	}
-	// Diagonal Scan Up-Left
-	for (int tracerC = col - 1, tracerR = row + 1; tracerC >= 0 && tracerR <= 7; --tracerC, ++tracerR)
-	{
-		scanner = getSquareContents(tracerC, tracerR);
+//	Returns true if the path from the piece to a destination square is free of obstructions.
+bool chessBoardClass::isPathClear(chessPiece& piece, int destC, int destR)
+{
+	int origin = squareIndex(piece.getColumn(), piece.getRow());
 
-		if (scanner == NULL)
-			continue;
-		else
-		{
-			color = scanner->getColor();
-			type = scanner->getType();
+	// Path from (origC, origR) to (destC, destR) is not obstructed if none of the squares in between are occupied.
+	return (betweenSquares(origin, squareIndex(destC, destR)) & occupiedBB) == 0;
+}
 
-			if (color == enemyColor)						    // Make sure pawn is within attack range to register a check
-				if (type == QUEEN || type == BISHOP || ((type == PAWN && tracerC == col - 1 && tracerR == row + 1)) || (type == KING && tracerC == col - 1 && tracerR == row + 1))
-					if (type == PAWN && color == WHITE)
-						break;
-					else
-						attackers.push_back(scanner);
+/*
+	======================================================
+	Movement Related Methods - Movement Handling and Logic
+	======================================================
+*/
 
-			break;
-		}
-	}
-	// Diagonal Scan Down-Left
-	for (int tracerC = col - 1, tracerR = row - 1; tracerC >= 0 && tracerR >= 0; --tracerC, --tracerR)
+// Function will move piece at (origC, origR) to (destC, destR), if legal.
+/*
+	Note: The parameter forceMove has a default value of false.  This is used with the chessGameTree
+	class to help when building game state nodes when we know the move is already legal.
+
+	For more info, consult the notes below, titled "Multi-Test Movement Logic Notes."
+*/
+bool chessBoardClass::move(int origC, int origR, int destC, int destR, bool noMove, bool forceMove)
+{
+	bool legalMove = false;
+
+	chessPiece* piece = getSquareContents(origC, origR);
+
+	// movementLogic() works from the board-analysis vectors, which makeMove() may have left out of date.
+	refreshAnalysis();
+
+	if (!forceMove)
 	{
-		scanner = getSquareContents(tracerC, tracerR);
+		// Can't move a piece that isn't there.
+		if (!piece)
+			return false;
 
-		if (scanner == NULL)
-			continue;
-		else
-		{
-			color = scanner->getColor();
-			type = scanner->getType();
-			if (color == enemyColor)						 // Make sure pawn is within attack range to register a check
-				if (type == QUEEN || type == BISHOP || ((type == PAWN && tracerC == col - 1 && tracerR == row - 1)) || (type == KING && tracerC == col - 1 && tracerR == row - 1))
-					if (type == PAWN && color == BLACK)
-						break;
-					else
-						attackers.push_back(scanner);
+		// White player can't move black pieces, vice-versa.
+		if (piece->getColor() != turn)
+			return false;
 
-			break;
-		}
+		// Can't keep playing a game that's over.
+		if (checkmate)
+			return false;
+
+		legalMove = movementLogic(*piece, destC, destR);
+
+		if (noMove)
+			return legalMove;
 	}
-	// Diagonal Scan Down-Right
-	for (int tracerC = col + 1, tracerR = row - 1; tracerC <= 7 && tracerR >= 0; ++tracerC, --tracerR)
+
+	if ((legalMove && noMove == false) || forceMove)
 	{
-		scanner = getSquareContents(tracerC, tracerR);
+		// Does the pointer manipulation needed to perform the actual move.
+		performMove(*piece, destC, destR);
+		
+		// Note:  This clears checkVector, escapeVector, attackVector, and saviorVector
+		swapTurn();
+		
+		// Move has been performed and it is now the other player's turn.
 
-		if (scanner == NULL)
-			continue;
-		else
+		// Scan to see if the current player's king is now in check, as a result of the move.
+		updateBoardAnalysis();
+
+		// Print out checkVector, attackVector, saviorVector, and escapeVector contents
+		if (DEBUG)
 		{
-			color = scanner->getColor();
-			type = scanner->getType();
+			using std::cout;
+			using std::endl;
 
-			if (color == enemyColor)						 // Make sure pawn is within attack range to register a check
-				if (type == QUEEN || type == BISHOP || ((type == PAWN && tracerC == col + 1 && tracerR == row - 1)) || (type == KING && tracerC == col + 1 && tracerR == row - 1))
-					if (type == PAWN && color == BLACK)
-						break;
-					else
-						attackers.push_back(scanner);
+			cout << "\n\n\n\n\n\n\n\n\n\n\n" << endl;
 
-			break;
+			// checkVector - Displays the checking piece or pieces and their coordinates
+			cout << endl;
+			cout << "====================" << endl
+				 <<	"checkVector Contents" << endl << endl;
+		
+			if (checkVector.empty())
+				cout << "No content" << endl;
+			else
+				for (int i = 0; i < checkVector.size(); ++i)
+				{
+					chessPiece* piece = checkVector[i];
+					cout << piece->getColor() << " " << piece->getType()
+						 << " -> (" << piece->getColumn() << ", " << piece->getRow() << ")" << endl;
+				}
+
+			// pinVector - Displays the pieces that are currently pinned and their coordinates,
+			//			   as well as the piece causing the pin and its coordinates.
+			cout << "====================" << endl
+				<< "pinVector Contents" << endl << endl;
+
+			if (pinVector.empty())
+				cout << "No content" << endl;
+			else
+				for (int i = 0; i < pinVector.size(); ++i)
+				{
+					chessPiece* pinnedPiece = pinVector[i].first.first;
+					chessPiece* attackPiece = pinVector[i].first.second;
+					cout << pinnedPiece->getColor() << " " << pinnedPiece->getType()
+						<< " -> (" << pinnedPiece->getColumn() << ", " << pinnedPiece->getRow() << "), ";
+
+					cout << attackPiece->getColor() << " " << attackPiece->getType()
+						<< " -> (" << attackPiece->getColumn() << ", " << attackPiece->getRow() << ") :: ";
+
+					cout << "Pin Direction: ";
+					switch (pinVector[i].second)
+					{
+					case RIGHT: cout << "RIGHT" << endl; break;
+					case UP_RIGHT: cout << "UP_RIGHT" << endl; break;
+					case UP: cout << "UP" << endl; break;
+					case UP_LEFT: cout << "UP_LEFT" << endl; break;
+					case LEFT: cout << "LEFT" << endl; break;
+					case DOWN_LEFT: cout << "DOWN_LEFT" << endl; break;
+					case DOWN: cout << "DOWN" << endl; break;
+					case DOWN_RIGHT: cout << "DOWN_RIGHT" << endl; break;
+					}
+				}
+
+			// attackVector - Coordinates of all the squares that are under attack by checkers.
+			cout << "=====================" << endl
+			 	 << "attackVector Contents" << endl << endl;
+
+			if (attackVector.empty())
+				cout << "No content" << endl;
+			else
+				for (int i = 0; i < attackVector.size(); ++i)
+				{
+					std::pair<int, int> coord = attackVector[i];
+
+					cout << "(" << coord.first << ", " << coord.second << ")" << endl;
+				}
+
+			// saviorVector - The pieces that can save the king from check and their coordiantes.
+			cout << "=====================" << endl
+				 << "saviorVector Contents" << endl <<  endl;
+		
+			if (saviorVector.empty())
+				cout << "No content" << endl;
+			else
+				for (int i = 0; i < saviorVector.size(); ++i)
+				{
+					chessPiece* piece = saviorVector[i];
+
+					cout << piece->getColor() << " " << piece->getType()
+						 << " -> (" << piece->getColumn() << ", " << piece->getRow() << ")" << endl;
+				}
+
+			// escapeVector - The coordinates of safe squares that the king can be moved to.
+			cout << "=====================" << endl
+				 << "escapeVector Contents" << endl << endl;
+		
+			if (escapeVector.empty())
+				cout << "No content" << endl;
+			else
+				for (int i = 0; i < escapeVector.size(); ++i)
+				{
+					std::pair<int, int> coord = escapeVector[i];
+
+					cout << "(" << coord.first << ", " << coord.second << ")" << endl;
+				}
+
+			cout << "========================" << endl;
+			cout << "******************************" << endl;
 		}
+		
+		return true;
 	}
-
-	/*
-	=============
-	Knight Attack
-	=============
-	Threat:  Obvious
-	*/
-	// Note: getSquareContents returns NULL if arguments are outside of array boundaries.
-
-	// Scan around board[col][row] for an attacking enemy knight.
-
-	// Up 1, Right 2
-	scanner = getSquareContents(col + 2, row + 1);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// Up 2, Right 1
-	scanner = getSquareContents(col + 1, row + 2);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// Up 2, Left 1
-	scanner = getSquareContents(col - 1, row + 2);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// Up 1, Left 2
-	scanner = getSquareContents(col - 2, row + 1);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// Down 1, Left 2
-	scanner = getSquareContents(col - 2, row - 1);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// Down 2, Left 1
-	scanner = getSquareContents(col - 1, row - 2);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// Down 2, Right 1
-	scanner = getSquareContents(col + 1, row - 2);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// Down 1, Right 2
-	scanner = getSquareContents(col + 2, row - 1);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// All possible threats scanned for, return results.
-	return attackers;
+	else
+		return false;
+		
 }
 
-// Function will return a vector of pair<int, int> elements that are squares in proximity
-// to the king that it may move to escape check.
-std::vector<std::pair<int, int>> chessBoardClass::scanForEscapeSquares(chessPiece& king)
+//	Helper function to move(), does a lot of the lower-level data handling.
+void chessBoardClass::performMove(chessPiece& piece, int destC, int destR, bool forceMove, PIECE_TYPE promotion)
 {
-	int kingCol = king.getColumn();
-	int kingRow = king.getRow();
+	int origC = piece.getColumn(), origR = piece.getRow();
 
-	std::vector<std::pair<int, int>> coordinateVector;
+	chessPiece* occupier = getSquareContents(destC, destR);
 
-	chessPiece* occupier;
+	// The pieces are kept in the Zobrist key by the bitboard helpers, but the castling rights and en passant flags
+	// the move changes are taken care of here.
+	int castleRights = getCastleRights();
 
-	// Scan through the 8 squares adjacent to the king, storing the
-	// coordinates to squares that the king can move to to escape check.
-	for (int tracerC = kingCol - 1; (tracerC <= kingCol + 1) && (tracerC <= 7); ++tracerC)
+	if (piece.getType() == PAWN && getMoveFlag(piece))
+		zobristKey ^= zobristEnPassantKeys[squareIndex(origC, origR)];
+
+	// Special Movement Case:  En Passant Capture
+	// All movement tests have passed at this point.
+	if (piece.getType() == PAWN && origC != destC)
 	{
-		if (tracerC < 0)	// Don't start the scan out of bounds.
-			continue;
+		// Attack diagonal is empty, so the target must be an en-passant eligible pawn.
+		if (occupier == NULL)
+		{
+			occupier = getSquareContents(destC, origR);
+			
+			// Set board square to point to NULL, so display function doesn't 
+			// try to access an invalid memory address
+			board[destC][origR] = NULL;
+		}
+		// The rest of the function takes care of the remaining work.
+	}
 
-		for (int tracerR = kingRow - 1; (tracerR <= kingRow + 1) && (tracerR <= 7); ++tracerR)
+	// Special Movement Case:  Castling
+	// All movement tests have been performed -> just move the pieces.
+	if (piece.getType() == KING && abs(origC - destC) == 2)
+	{
+		chessPiece* rook;
+		// Castle Queen-Side
+		if (destC < origC)
 		{
-			if (tracerR < 0)	// Don't start the scan out of bounds.
-				continue;
+			// Grab the rook pointer from the board.
+			rook = getSquareContents(0, origR);
 
-			// Check to see if square is currently occupied.
-			occupier = getSquareContents(tracerC, tracerR);
+			// Clear the necessary board pointers.
+			board[origC][origR] = NULL;
+			board[0][origR] = NULL;
 
-			if (occupier != NULL)
-			{
-				if (occupier->getColor() == king.getColor())	// Square is currently occupied by friendly piece.
-					continue;
-				else if (occupier->getColor() != king.getColor())	// Square is occupied by an enemy piece.
-				{
-					std::vector<chessPiece*> attackers = getAttackers(&king, tracerC, tracerR);
-					if (attackers.size() == 0)
-						coordinateVector.push_back(std::make_pair(tracerC, tracerR));	// If enemy is undefended, it's a safe square to take.
-					else
-						continue;	// If enemy is defended, then square can't be taken.
-				}
-			}
-			else if (occupier == NULL)
-			{
-				std::vector<chessPiece*> attackers = getAttackers(&king, tracerC, tracerR);
-				if (attackers.size() == 0)
-					coordinateVector.push_back(std::make_pair(tracerC, tracerR));	// Square is unoccupied and not under attack
-				else
-					continue;	// Square is unoccupied, but under attack (not safe).
-			}
+			// Set the pieces in place, sync board.
+			piece.moveTo(destC, destR);
+			board[destC][destR] = &piece;
+			rook->moveTo(destC + 1, destR);	// Queen-side castle -> rook is right of the king.
+			board[destC + 1][destR] = rook;
+
+			removeFromBitboards(rook->getColor(), rook->getType(), 0, origR);
+			addToBitboards(rook->getColor(), rook->getType(), destC + 1, destR);
+		}
+		else // Castle King-Side
+		{
+			// Grab the rook pointer from the board.
+			rook = getSquareContents(7, origR);
+
+			// Clear the necessary board pointers.
+			board[origC][origR] = NULL;
+			board[7][origR] = NULL;
+
+			// Set the pieces in place, sync board.
+			piece.moveTo(destC, destR);
+			board[destC][destR] = &piece;
+			rook->moveTo(destC - 1, destR);	// King-side castle -> rook is right of the king.
+			board[destC - 1][destR] = rook;
+
+			removeFromBitboards(rook->getColor(), rook->getType(), 7, origR);
+			addToBitboards(rook->getColor(), rook->getType(), destC - 1, destR);
 		}
 	}
 
-	return coordinateVector;
-}
+	// Vanilla Movement Case
+	// If target square is occupied, delete the occupier.
+	if (occupier != NULL)
+	{
+		occupier->setCaptured(true);
+		PIECE_COLOR color = occupier->getColor();
+		PIECE_TYPE type = occupier->getType();
+
+		// The occupier still knows its own square, which differs from the destination for en passant.
+		removeFromBitboards(color, type, occupier->getColumn(), occupier->getRow());
 
-//	Specially designed for use in the scanForEscapeSquares method, to test if a square is safe under non-check king movement.
-//	The issue:  The reason why this function is necessary is due to the fact that the original version has a significant oversight.
-//				The oversight is that it the other getAttackers method fails to take into account that the king is in the way during
-//				the eight-directional scanForEscapeSquares scan, so it won't detect bishops, rooks, and queens if the conditions are right.
-//	The solution:	Temporarily modify the board so that the appropriate square no longer points to the king.  After the scans, point the
-//					board back to the king.
-std::vector<chessPiece*> chessBoardClass::getAttackers(chessPiece* king, int col, int row)
-{
-	std::vector<chessPiece*> attackers;
+		if (type == PAWN && getMoveFlag(*occupier))
+			zobristKey ^= zobristEnPassantKeys[squareIndex(occupier->getColumn(), occupier->getRow())];
 
-	board[king->getColumn()][king->getRow()] = NULL;
+		// A vector element's erase flag is set to true.
+		/* This will erase the piece from its vector so it doesn't cause problems.
+		// This is needed since deleting a pointer that is an element of a vector
+		// doesn't erase it from the vector.  Since the pin-check test in the movementLogic
+		// method below relies on copying the piece vectors into a new chessBoardClass
+		// instance, we can't be copying dangling pointers that don't actually point
+		// to anything. */
+	}
 
-	PIECE_COLOR friendlyColor = turn;
-	PIECE_COLOR enemyColor;
+	// Move the piece to the target testination, sync the board.
+	piece.moveTo(destC, destR);
+	board[destC][destR] = &piece;
 
-	if (turn == WHITE)
-		enemyColor = BLACK;
-	else
-		enemyColor = WHITE;
+	removeFromBitboards(piece.getColor(), piece.getType(), origC, origR);
+	addToBitboards(piece.getColor(), piece.getType(), destC, destR);
 
-	chessPiece* scanner;
-	PIECE_COLOR color;
-	PIECE_TYPE type;
+	// Note:	piece->moveTo() handles setting the enPassant flag or 
+	//			canCastle flag of pawn and rook/king pieces appropriately.
+	if (piece.getType() == PAWN && getMoveFlag(piece))
+		zobristKey ^= zobristEnPassantKeys[squareIndex(destC, destR)];
 
-	/*
-	=================
-	Horizontal Attack
-	=================
-	Threats:  Queen, Rook, or King
-	*/
+	// Original spot is empty after the move.
+	board[origC][origR] = NULL;
 
-	// Horizontal Scan Left
-	for (int tracerC = col - 1; tracerC >= 0; --tracerC)
-	{
-		scanner = getSquareContents(tracerC, row);
+	// Special Movement Case:  Pawn Promotion
+	if (piece.getType() == PAWN && (destR == 0 || destR == 7) && !forceMove)
+	{	
+		// Flag the pawn for erasure.
+		piece.setCaptured(true);
 
-		if (scanner == NULL)
-			continue;
-		else
-		{
-			color = scanner->getColor();
-			type = scanner->getType();
+		// Only way for a pawn to reach row 0 (1st row) is for the pawn to be black, which means it needs to be promoted.
+		// Same thing applies to white pawns that reach row 7 (the last row).
+		pawnPromotion(piece, promotion);
 
-			if (color == enemyColor)
-				if (type == QUEEN || type == ROOK || (type == KING && tracerC == col - 1))
-					attackers.push_back(scanner);
+		PIECE_COLOR color = piece.getColor();
+		PIECE_TYPE type = piece.getType();
 
-			break;
-		}
+		// The promoted pawn needs to be deleted.
+		// cleanUpPieceVectors(color, type);
 	}
-	// Horizontal Scan Right
-	for (int tracerC = col + 1; tracerC <= 7; ++tracerC)
-	{
-		scanner = getSquareContents(tracerC, row);
 
-		if (scanner == NULL)
-			continue;
-		else
-		{
-			color = scanner->getColor();
-			type = scanner->getType();
+	// Moving a king or rook, or capturing a rook, can cost castling rights.
+	int newCastleRights = getCastleRights();
 
-			if (color == enemyColor)
-				if (type == QUEEN || type == ROOK || (type == KING && tracerC == col + 1))
-					attackers.push_back(scanner);
+	if (newCastleRights != castleRights)
+		zobristKey ^= zobristCastleKeys[castleRights] ^ zobristCastleKeys[newCastleRights];
 
-			break;
-		}
-	}
+	return;
+}
 
-	/*
-	===============
-	Vertical Attack
-	===============
-	Threats:  Queen, Rook, or King
-	*/
+//	Performs a move that is already known to be legal.  Nothing is checked here; the caller (the AI search) has
+//	already done that.  Everything the move changes is recorded in undo, so that unmakeMove() can restore the
+//	board exactly, which is a lot cheaper than copying the whole board for every position that is looked at.
+void chessBoardClass::makeMove(int origC, int origR, int destC, int destR, undoInfo& undo, PIECE_TYPE promotion)
+{
+	chessPiece* piece = board[origC][origR];
 
-	// Vertical Scan Down
-	for (int tracerR = row - 1; tracerR >= 0; --tracerR)
-	{
-		scanner = getSquareContents(col, tracerR);
+	undo.piece = piece;
+	undo.origC = origC;
+	undo.origR = origR;
+	undo.destC = destC;
+	undo.destR = destR;
+	undo.pieceFlag = getMoveFlag(*piece);
+	undo.turn = turn;
+	undo.zobristKey = zobristKey;
+	undo.phaseScores[MIDGAME] = phaseScores[MIDGAME];
+	undo.phaseScores[ENDGAME] = phaseScores[ENDGAME];
+	undo.gamePhase = gamePhase;
 
-		if (scanner == NULL)
-			continue;
-		else
-		{
-			color = scanner->getColor();
-			type = scanner->getType();
+	undo.colorBB[WHITE] = colorBB[WHITE];
+	undo.colorBB[BLACK] = colorBB[BLACK];
+	for (int i = 0; i < 6; ++i)
+		undo.typeBB[i] = typeBB[i];
+	undo.occupiedBB = occupiedBB;
 
-			if (color == enemyColor)
-				if (type == QUEEN || type == ROOK || (type == KING && tracerR == row - 1))
-					attackers.push_back(scanner);
+	// Captured piece.  A diagonal pawn move onto an empty square is an en passant capture.
+	undo.captured = board[destC][destR];
+	undo.capturedC = destC;
+	undo.capturedR = destR;
 
-			break;
-		}
-	}
-	// Vertical Scan Up
-	for (int tracerR = row + 1; tracerR <= 7; ++tracerR)
+	if (undo.captured == NULL && piece->getType() == PAWN && origC != destC)
 	{
-		scanner = getSquareContents(col, tracerR);
-
-		if (scanner == NULL)
-			continue;
-		else
-		{
-			color = scanner->getColor();
-			type = scanner->getType();
+		undo.captured = board[destC][origR];
+		undo.capturedR = origR;
+	}
 
-			if (color == enemyColor)
-				if (type == QUEEN || type == ROOK || (type == KING && tracerR == row + 1))
-					attackers.push_back(scanner);
+	// Castling also moves a rook.
+	undo.rook = NULL;
 
-			break;
+	if (piece->getType() == KING && abs(origC - destC) == 2)
+	{
+		if (destC < origC)	// Queen-side
+		{
+			undo.rookOrigC = 0;
+			undo.rookDestC = destC + 1;
+		}
+		else // King-side
+		{
+			undo.rookOrigC = 7;
+			undo.rookDestC = destC - 1;
 		}
+
+		undo.rook = board[undo.rookOrigC][origR];
 	}
 
-	/*
-	===============
-	Diagonal Attack
-	===============
-	Threats:  Queen, Bishop, Pawn, or King
-	*/
+	performMove(*piece, destC, destR, false, promotion);
 
-	// Diagonal Scan Up-Right
-	for (int tracerC = col + 1, tracerR = row + 1; tracerC <= 7 && tracerR <= 7; ++tracerC, ++tracerR)
-	{
-		scanner = getSquareContents(tracerC, tracerR);
+	undo.promoted = NULL;
 
-		if (scanner == NULL)
-			continue;
-		else
-		{
-			color = scanner->getColor();
-			type = scanner->getType();
+	if (piece->getType() == PAWN && (destR == 0 || destR == 7))
+		undo.promoted = board[destC][destR];
 
-			if (color == enemyColor)						// Make sure pawn is within attack range to register a check
-				if (type == QUEEN || type == BISHOP || ((type == PAWN && tracerC == col + 1 && tracerR == row + 1)) || (type == KING && tracerC == col + 1 && tracerR == row + 1))
-					if (type == PAWN && color == WHITE)
-						break;
-					else
-						attackers.push_back(scanner);
+	// swapTurn() clears the en passant flags of the side that moves next, so remember which ones were set.
+	undo.enPassantMask = getEnPassantMask((turn == WHITE) ? BLACK : WHITE);
 
-			break;
-		}
-	}
-	// Diagonal Scan Up-Left
-	for (int tracerC = col - 1, tracerR = row + 1; tracerC >= 0 && tracerR <= 7; --tracerC, ++tracerR)
-	{
-		scanner = getSquareContents(tracerC, tracerR);
+	swapTurn();
 
-		if (scanner == NULL)
-			continue;
-		else
-		{
-			color = scanner->getColor();
-			type = scanner->getType();
+	// The search works from the bitboards, so the analysis vectors are only worked out if something asks for them.
+	analysisStale = true;
+}
 
-			if (color == enemyColor)						    // Make sure pawn is within attack range to register a check
-				if (type == QUEEN || type == BISHOP || ((type == PAWN && tracerC == col - 1 && tracerR == row + 1)) || (type == KING && tracerC == col - 1 && tracerR == row + 1))
-					if (type == PAWN && color == WHITE)
-						break;
-					else
-						attackers.push_back(scanner);
+//	Passes the turn.  Only the side to move, and the en passant flags that swapTurn() clears, change.
+void chessBoardClass::makeNullMove(undoInfo& undo)
+{
+	undo.piece = NULL;
+	undo.turn = turn;
+	undo.zobristKey = zobristKey;
+	undo.enPassantMask = getEnPassantMask((turn == WHITE) ? BLACK : WHITE);
 
-			break;
-		}
-	}
-	// Diagonal Scan Down-Left
-	for (int tracerC = col - 1, tracerR = row - 1; tracerC >= 0 && tracerR >= 0; --tracerC, --tracerR)
-	{
-		scanner = getSquareContents(tracerC, tracerR);
+	swapTurn();
 
-		if (scanner == NULL)
-			continue;
-		else
-		{
-			color = scanner->getColor();
-			type = scanner->getType();
-			if (color == enemyColor)						 // Make sure pawn is within attack range to register a check
-				if (type == QUEEN || type == BISHOP || ((type == PAWN && tracerC == col - 1 && tracerR == row - 1)) || (type == KING && tracerC == col - 1 && tracerR == row - 1))
-					if (type == PAWN && color == BLACK)
-						break;
-					else
-						attackers.push_back(scanner);
+	analysisStale = true;
+}
 
-			break;
-		}
+//	Takes back a move made by makeNullMove().
+void chessBoardClass::unmakeNullMove(undoInfo& undo)
+{
+	turn = undo.turn;
+	zobristKey = undo.zobristKey;
+	checkmate = false;
+	analysisStale = true;
+
+	restoreEnPassant((turn == WHITE) ? BLACK : WHITE, undo.enPassantMask);
+}
+
+//	Returns a mask with bit i set if pawn i of the given color has its enPassant flag set.
+int chessBoardClass::getEnPassantMask(PIECE_COLOR color)
+{
+	int mask = 0;
+
+	if (color == WHITE)
+	{
+		for (int i = 0; i < wPawns.size(); ++i)
+			if (wPawns[i].getEnPassant())
+				mask |= (1 << i);
 	}
-	// Diagonal Scan Down-Right
-	for (int tracerC = col + 1, tracerR = row - 1; tracerC <= 7 && tracerR >= 0; ++tracerC, --tracerR)
+	else
 	{
-		scanner = getSquareContents(tracerC, tracerR);
-
-		if (scanner == NULL)
-			continue;
-		else
-		{
-			color = scanner->getColor();
-			type = scanner->getType();
+		for (int i = 0; i < bPawns.size(); ++i)
+			if (bPawns[i].getEnPassant())
+				mask |= (1 << i);
+	}
 
-			if (color == enemyColor)						 // Make sure pawn is within attack range to register a check
-				if (type == QUEEN || type == BISHOP || ((type == PAWN && tracerC == col + 1 && tracerR == row - 1)) || (type == KING && tracerC == col + 1 && tracerR == row - 1))
-					if (type == PAWN && color == BLACK)
-						break;
-					else
-						attackers.push_back(scanner);
+	return mask;
+}
 
-			break;
-		}
+//	Sets the enPassant flag of each pawn of the given color that has its bit set in mask.
+void chessBoardClass::restoreEnPassant(PIECE_COLOR color, int mask)
+{
+	if (color == WHITE)
+	{
+		for (int i = 0; i < wPawns.size(); ++i)
+			if (mask & (1 << i))
+				wPawns[i].setEnPassant(true);
+	}
+	else
+	{
+		for (int i = 0; i < bPawns.size(); ++i)
+			if (mask & (1 << i))
+				bPawns[i].setEnPassant(true);
 	}
+}
 
-	/*
-	=============
-	Knight Attack
-	=============
-	Threat:  Obvious
-	*/
-	// Note: getSquareContents returns NULL if arguments are outside of array boundaries.
-
-	// Scan around board[col][row] for an attacking enemy knight.
-
-	// Up 1, Right 2
-	scanner = getSquareContents(col + 2, row + 1);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// Up 2, Right 1
-	scanner = getSquareContents(col + 1, row + 2);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// Up 2, Left 1
-	scanner = getSquareContents(col - 1, row + 2);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// Up 1, Left 2
-	scanner = getSquareContents(col - 2, row + 1);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// Down 1, Left 2
-	scanner = getSquareContents(col - 2, row - 1);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// Down 2, Left 1
-	scanner = getSquareContents(col - 1, row - 2);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// Down 2, Right 1
-	scanner = getSquareContents(col + 1, row - 2);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// Down 1, Right 2
-	scanner = getSquareContents(col + 2, row - 1);
-	if (scanner != NULL)
-		if (scanner->getColor() == enemyColor && scanner->getType() == KNIGHT)
-			attackers.push_back(scanner);
-
-	// All possible threats scanned for, return results.
-
-	board[king->getColumn()][king->getRow()] = king;
+//	Same as above, for a move written out by generateMoves().
+void chessBoardClass::makeMove(chessMove move, undoInfo& undo)
+{
+	PIECE_TYPE promotion = (move.getFlag() == PROMOTION_MOVE) ? move.getPromotion() : QUEEN;
 
-	return attackers;
+	makeMove(move.getOrigC(), move.getOrigR(), move.getDestC(), move.getDestR(), undo, promotion);
 }
 
-//	Returns true if the path from the piece to a destination square is free of obstructions.
-bool chessBoardClass::isPathClear(chessPiece& piece, int destC, int destR)
+//	Takes back a move made by makeMove(), restoring the board to the state recorded in undo.
+void chessBoardClass::unmakeMove(undoInfo& undo)
 {
-	int origC = piece.getColumn(), origR = piece.getRow();
+	chessPiece* piece = undo.piece;
 
-	chessPiece* scanner;
+	turn = undo.turn;
+	zobristKey = undo.zobristKey;
+	phaseScores[MIDGAME] = undo.phaseScores[MIDGAME];
+	phaseScores[ENDGAME] = undo.phaseScores[ENDGAME];
+	gamePhase = undo.gamePhase;
+	checkmate = false;
+	analysisStale = true;
 
-	// Non-diagonal movement cases
-	if (origR == destR)	// Horizontal Movement
-	{
-		if (origC > destC) // Leftward Movement
-		{
-			for (int tracerC = origC - 1; tracerC != destC; --tracerC)
-			{
-				scanner = getSquareContents(tracerC, destR);
-				if (scanner != NULL)
-					return false;
-			}
-		}
-		else if (origC < destC) // Rightward Movement
-		{
-			for (int tracerC = origC + 1; tracerC != destC; ++tracerC)
-			{
-				scanner = getSquareContents(tracerC, destR);
-				if (scanner != NULL)
-					return false;
-			}
-		}
-	}
-	else if (origC == destC) // Vertical Movement
+	colorBB[WHITE] = undo.colorBB[WHITE];
+	colorBB[BLACK] = undo.colorBB[BLACK];
+	for (int i = 0; i < 6; ++i)
+		typeBB[i] = undo.typeBB[i];
+	occupiedBB = undo.occupiedBB;
+
+	// Restore the en passant flags that swapTurn() cleared.
+	restoreEnPassant((turn == WHITE) ? BLACK : WHITE, undo.enPassantMask);
+
+	// A promoted piece is always the last one pushed onto its vector, since moves are taken back in reverse order.
+	if (undo.promoted != NULL)
 	{
-		if (origR < destR) // Upward Movement
-		{
-			for (int tracerR = origR + 1; tracerR != destR; ++tracerR)
-			{
-				scanner = getSquareContents(destC, tracerR);
-				if (scanner != NULL)
-					return false;
-			}
-		}
-		else if (origR > destR) // Downward Movement
+		PIECE_COLOR color = undo.promoted->getColor();
+
+		switch (undo.promoted->getType())
 		{
-			for (int tracerR = origR - 1; tracerR != destR; --tracerR)
-			{
-				scanner = getSquareContents(destC, tracerR);
-				if (scanner != NULL)
-					return false;
-			}
+		case KNIGHT:
+			if (color == WHITE) wKnights.pop_back(); else bKnights.pop_back();
+			break;
+		case BISHOP:
+			if (color == WHITE) wBishops.pop_back(); else bBishops.pop_back();
+			break;
+		case ROOK:
+			if (color == WHITE) wRooks.pop_back(); else bRooks.pop_back();
+			break;
+		default: // QUEEN
+			if (color == WHITE) wQueens.pop_back(); else bQueens.pop_back();
 		}
+
+		piece->setCaptured(false);
 	}
 
-	// Diagonal movement cases
-	if (origC > destC) // Leftward Movement
+	// Put the moved piece back.
+	board[undo.destC][undo.destR] = NULL;
+	piece->moveTo(undo.origC, undo.origR);
+	setMoveFlag(*piece, undo.pieceFlag);
+	board[undo.origC][undo.origR] = piece;
+
+	// Put the castling rook back.  It must have been eligible to castle, or the move couldn't have been made.
+	if (undo.rook != NULL)
 	{
-		if (origR > destR) // Left-Down Movement
-		{
-			for (int tracerC = origC - 1, tracerR = origR - 1; tracerC != destC && tracerR != destR; --tracerC, --tracerR)
-			{
-				scanner = getSquareContents(tracerC, tracerR);
-				if (scanner != NULL)
-					return false;
-			}
-		}
-		else if (origR < destR) // Left-Up Movement
-		{
-			for (int tracerC = origC - 1, tracerR = origR + 1; tracerC != destC && tracerR != destR; --tracerC, ++tracerR)
-			{
-				scanner = getSquareContents(tracerC, tracerR);
-				if (scanner != NULL)
-					return false;
-			}
-		}
+		board[undo.rookDestC][undo.origR] = NULL;
+		undo.rook->moveTo(undo.rookOrigC, undo.origR);
+		setMoveFlag(*undo.rook, true);
+		board[undo.rookOrigC][undo.origR] = undo.rook;
 	}
-	else if (origC < destC) // Rightward Movement
+
+	// Put the captured piece back.
+	if (undo.captured != NULL)
 	{
-		if (origR > destR) // Right-Down Movement
-		{
-			for (int tracerC = origC + 1, tracerR = origR - 1; tracerC != destC && tracerR != destR; ++tracerC, --tracerR)
-			{
-				scanner = getSquareContents(tracerC, tracerR);
-				if (scanner != NULL)
-					return false;
-			}
-		}
-		else if (origR < destR) // Right-Up Movement
-		{
-			for (int tracerC = origC + 1, tracerR = origR + 1; tracerC != destC && tracerR != destR; ++tracerC, ++tracerR)
-			{
-				scanner = getSquareContents(tracerC, tracerR);
-				if (scanner != NULL)
-					return false;
-			}
-		}
+		undo.captured->setCaptured(false);
+		board[undo.capturedC][undo.capturedR] = undo.captured;
 	}
-
-	// Path from (origC, origR) to (destC, destR) is not obstructed.
-	return true;
 }
 
+//	Legal move generation.
 /*
-	======================================================
-	Movement Related Methods - Movement Handling and Logic
-	======================================================
-*/
+	Rather than trying every square for every piece with move(), the legal moves are worked out directly
+	from the bitboards.  Two masks computed once per position take care of almost all of the legality testing:
 
-// Function will move piece at (origC, origR) to (destC, destR), if legal.
-/*
-	Note: The parameter forceMove has a default value of false.  This is used with the chessGameTree
-	class to help when building game state nodes when we know the move is already legal.
+	-	Check mask:  If the king is in check by one piece, the only non-king moves that help are capturing the
+		checker or blocking the squares between it and the king.  If there is no check, every square is allowed.
+		If there are two checkers, only the king can move.
+	-	Pins:  A pinned piece may only move along the line through its king and itself.
 
-	For more info, consult the notes below, titled "Multi-Test Movement Logic Notes."
+	The king's own moves are tested by asking whether the destination is attacked with the king lifted off the
+	board, so that it can't hide behind itself from a slider.  En passant is the one odd case, since two pawns
+	leave the same row at once, so it gets a full attack test with both pawns removed.
+
+	For the quiescence search, CAPTURE_MOVES narrows the destinations down to enemy pieces (and the last row,
+	for pawns), and leaves castling out.  QUIET_MOVES is everything else, so the search can put off writing out
+	the quiet moves until it has tried the captures.
 */
-bool chessBoardClass::move(int origC, int origR, int destC, int destR, bool noMove, bool forceMove)
+int chessBoardClass::generateMoves(moveList& moves, MOVE_GEN kind, bitboard fromSquares)
 {
-	bool legalMove = false;
+	int start = moves.size();
 
-	chessPiece* piece = getSquareContents(origC, origR);
+	PIECE_COLOR friendly = turn;
+	PIECE_COLOR enemy = (turn == WHITE) ? BLACK : WHITE;
 
-	if (!forceMove)
+	chessPiece& king = (turn == WHITE) ? static_cast<chessPiece&>(wKing.front()) : static_cast<chessPiece&>(bKing.front());
+	int kingSquare = squareIndex(king.getColumn(), king.getRow());
+
+	bitboard friendlyPieces = colorBB[friendly];
+	bitboard checkers = attackersTo(kingSquare, enemy, occupiedBB);
+
+	// Squares a piece may move to, before checks and pins are taken into account.
+	bitboard allowed = ~friendlyPieces;
+	if (kind == CAPTURE_MOVES)
+		allowed = colorBB[enemy];
+	else if (kind == QUIET_MOVES)
+		allowed = ~occupiedBB;
+
+	bool kingMoves = (fromSquares & squareBit(kingSquare)) != 0;
+
+	// King moves:  Any adjacent square not holding a friendly piece, that isn't attacked once the king has moved.
+	bitboard kingTargets = kingMoves ? kingAttacks(kingSquare) & allowed : 0;
+	bitboard withoutKing = occupiedBB & ~squareBit(kingSquare);
+
+	while (kingTargets != 0)
 	{
-		// Can't move a piece that isn't there.
-		if (!piece)
-			return false;
+		int to = popLowestSquare(kingTargets);
 
-		// White player can't move black pieces, vice-versa.
-		if (piece->getColor() != turn)
-			return false;
+		if (attackersTo(to, enemy, withoutKing) == 0)
+			addMoves(moves, kingSquare, squareBit(to));
+	}
 
-		// Can't keep playing a game that's over.
-		if (checkmate)
-			return false;
+	// Double check:  Only the king can move.
+	if (popCount(checkers) > 1)
+		return moves.size() - start;
+
+	// Squares the other pieces have to move to, to deal with a check.
+	bitboard checkMask = ~bitboard(0);
+	if (checkers != 0)
+		checkMask = checkers | betweenSquares(kingSquare, lowestSquare(checkers));
+
+	bitboard pinned = getPinned(friendly);
+
+	// Knights, bishops, rooks, and queens.
+	bitboard pieces = friendlyPieces & fromSquares & ~typeBB[PAWN] & ~typeBB[KING];
+	while (pieces != 0)
+	{
+		int from = popLowestSquare(pieces);
+		bitboard targets;
+
+		switch (board[squareColumn(from)][squareRow(from)]->getType())
+		{
+		case KNIGHT:
+			targets = knightAttacks(from);
+			break;
+		case BISHOP:
+			targets = bishopAttacks(from, occupiedBB);
+			break;
+		case ROOK:
+			targets = rookAttacks(from, occupiedBB);
+			break;
+		default:	// QUEEN
+			targets = queenAttacks(from, occupiedBB);
+			break;
+		}
+
+		targets &= allowed & checkMask;
 
-		legalMove = movementLogic(*piece, destC, destR);
+		if (pinned & squareBit(from))
+			targets &= lineThrough(kingSquare, from);
 
-		if (noMove)
-			return legalMove;
+		addMoves(moves, from, targets);
 	}
 
-	if ((legalMove && noMove == false) || forceMove)
+	// Pawns.
+	int forward = (friendly == WHITE) ? 8 : -8;
+	int startRow = (friendly == WHITE) ? 1 : 6;
+	const bitboard lastRows = 0xFF000000000000FFull;
+
+	bitboard pawns = friendlyPieces & fromSquares & typeBB[PAWN];
+	while (pawns != 0)
 	{
-		// Does the pointer manipulation needed to perform the actual move.
-		performMove(*piece, destC, destR);
-		
-		// Note:  This clears checkVector, escapeVector, attackVector, and saviorVector
-		swapTurn();
-		
-		// Move has been performed and it is now the other player's turn.
+		int from = popLowestSquare(pawns);
+		bitboard targets = pawnAttacks(friendly, from) & colorBB[enemy];
 
-		// Scan to see if the current player's king is now in check, as a result of the move.
-		chessPiece* king;
-			if (turn == WHITE)
-				king = &wKing.front();
-			else
-				king = &bKing.front();
+		// Forward movement needs empty squares; two squares only from the starting row.
+		if (!(occupiedBB & squareBit(from + forward)))
+		{
+			targets |= squareBit(from + forward);
+
+			if (squareRow(from) == startRow && !(occupiedBB & squareBit(from + 2 * forward)))
+				targets |= squareBit(from + 2 * forward);
+		}
 
-		// Populate checkVector with any pieces that are putting otherKing in check.
-		checkVector = scanForCheck(*king);
+		// A push only counts as a capture when it promotes.
+		if (kind == CAPTURE_MOVES)
+			targets &= colorBB[enemy] | lastRows;
+		else if (kind == QUIET_MOVES)
+			targets &= ~colorBB[enemy] & ~lastRows;
 
-		// Populate escape vector with pair<int, int> board coordinates that represent
-		// squares that the king can safely move to.
-		escapeVector = scanForEscapeSquares(*king);
+		targets &= checkMask;
 
-		// Populate pinVector with any pieces that are currently pinned to their king.
-		pinVector = scanForPins(*king);
-		
-		// The king is in check, populate the appropriate vectors.
-		if (!checkVector.empty())
+		if (pinned & squareBit(from))
+			targets &= lineThrough(kingSquare, from);
+
+		addPawnMoves(moves, from, targets);
+
+		// En passant:  An enemy pawn that just moved two squares is beside this pawn.
+		for (int side = -1; side <= 1 && kind != QUIET_MOVES; side += 2)
 		{
-			// Populate attackVector with pair<int,int> board coordinates that represent
-			// squares between the checking piece(s) and the king.
-			attackVector = setAttackVector(*king);
+			int col = squareColumn(from) + side, row = squareRow(from);
+			chessPiece* occupier = getSquareContents(col, row);
 
-			// Populate saviorVector with chessPiece* elements that point to pieces that
-			// can take the king out of check by being moved to a coordinate in attackVector
-			saviorVector = scanForSaviors();
+			if (occupier == NULL || occupier->getType() != PAWN || occupier->getColor() != enemy || !getMoveFlag(*occupier))
+				continue;
+
+			int captured = squareIndex(col, row);
+			int to = captured + forward;
+
+			// Play the capture on the occupancy and make sure nothing can reach the king.
+			bitboard occupied = (occupiedBB & ~squareBit(from) & ~squareBit(captured)) | squareBit(to);
+			if ((attackersTo(kingSquare, enemy, occupied) & ~squareBit(captured)) == 0)
+				addMoves(moves, from, squareBit(to), EN_PASSANT_MOVE);
 		}
+	}
 
-		// If the king is in check,
-		// AND there are no escape squares,
-		// AND there are no savior pieces,
-		// then checkmate has occured.
-		if (checkVector.size() > 0 && escapeVector.empty() && saviorVector.empty())
-			checkmate = true;
+	// Castling:  The king and rook haven't moved, the king isn't in check, the squares between them are empty,
+	// and the king doesn't pass through or land on an attacked square.
+	if (kind != CAPTURE_MOVES && kingMoves && checkers == 0 && getMoveFlag(king))
+	{
+		int row = king.getRow();
 
-		// Print out checkVector, attackVector, saviorVector, and escapeVector contents
-		if (DEBUG)
+		for (int rookCol = 0; rookCol <= 7; rookCol += 7)
 		{
-			using std::cout;
-			using std::endl;
+			chessPiece* rook = board[rookCol][row];
 
-			cout << "\n\n\n\n\n\n\n\n\n\n\n" << endl;
+			if (rook == NULL || rook->getType() != ROOK || rook->getColor() != friendly || !getMoveFlag(*rook))
+				continue;
 
-			// checkVector - Displays the checking piece or pieces and their coordinates
-			cout << endl;
-			cout << "====================" << endl
-				 <<	"checkVector Contents" << endl << endl;
-		
-			if (checkVector.empty())
-				cout << "No content" << endl;
-			else
-				for (int i = 0; i < checkVector.size(); ++i)
-				{
-					chessPiece* piece = checkVector[i];
-					cout << piece->getColor() << " " << piece->getType()
-						 << " -> (" << piece->getColumn() << ", " << piece->getRow() << ")" << endl;
-				}
+			int rookSquare = squareIndex(rookCol, row);
+			if (betweenSquares(kingSquare, rookSquare) & occupiedBB)
+				continue;
 
-			// pinVector - Displays the pieces that are currently pinned and their coordinates,
-			//			   as well as the piece causing the pin and its coordinates.
-			cout << "====================" << endl
-				<< "pinVector Contents" << endl << endl;
+			int step = (rookCol == 0) ? -1 : 1;
+			if (attackersTo(kingSquare + step, enemy, occupiedBB) != 0 || attackersTo(kingSquare + 2 * step, enemy, occupiedBB) != 0)
+				continue;
 
-			if (pinVector.empty())
-				cout << "No content" << endl;
-			else
-				for (int i = 0; i < pinVector.size(); ++i)
-				{
-					chessPiece* pinnedPiece = pinVector[i].first.first;
-					chessPiece* attackPiece = pinVector[i].first.second;
-					cout << pinnedPiece->getColor() << " " << pinnedPiece->getType()
-						<< " -> (" << pinnedPiece->getColumn() << ", " << pinnedPiece->getRow() << "), ";
+			addMoves(moves, kingSquare, squareBit(kingSquare + 2 * step), CASTLE_MOVE);
+		}
+	}
 
-					cout << attackPiece->getColor() << " " << attackPiece->getType()
-						<< " -> (" << attackPiece->getColumn() << ", " << attackPiece->getRow() << ") :: ";
+	return moves.size() - start;
+}
 
-					cout << "Pin Direction: ";
-					switch (pinVector[i].second)
-					{
-					case RIGHT: cout << "RIGHT" << endl; break;
-					case UP_RIGHT: cout << "UP_RIGHT" << endl; break;
-					case UP: cout << "UP" << endl; break;
-					case UP_LEFT: cout << "UP_LEFT" << endl; break;
-					case LEFT: cout << "LEFT" << endl; break;
-					case DOWN_LEFT: cout << "DOWN_LEFT" << endl; break;
-					case DOWN: cout << "DOWN" << endl; break;
-					case DOWN_RIGHT: cout << "DOWN_RIGHT" << endl; break;
-					}
-				}
+//	Checks move against the legal moves of the piece on its origin square, which is far cheaper than writing out
+//	every move of the position.
+bool chessBoardClass::isLegal(chessMove move)
+{
+	if (!(colorBB[turn] & squareBit(move.getFrom())))
+		return false;
 
-			// attackVector - Coordinates of all the squares that are under attack by checkers.
-			cout << "=====================" << endl
-			 	 << "attackVector Contents" << endl << endl;
+	moveList moves;
+	generateMoves(moves, ALL_MOVES, squareBit(move.getFrom()));
 
-			if (attackVector.empty())
-				cout << "No content" << endl;
-			else
-				for (int i = 0; i < attackVector.size(); ++i)
-				{
-					std::pair<int, int> coord = attackVector[i];
+	for (int i = 0; i < moves.size(); ++i)
+		if (moves[i] == move)
+			return true;
 
-					cout << "(" << coord.first << ", " << coord.second << ")" << endl;
-				}
+	return false;
+}
 
-			// saviorVector - The pieces that can save the king from check and their coordiantes.
-			cout << "=====================" << endl
-				 << "saviorVector Contents" << endl <<  endl;
-		
-			if (saviorVector.empty())
-				cout << "No content" << endl;
-			else
-				for (int i = 0; i < saviorVector.size(); ++i)
-				{
-					chessPiece* piece = saviorVector[i];
+//	Returns the pieces of the given color that are the only piece between their king and an enemy slider.
+bitboard chessBoardClass::getPinned(PIECE_COLOR color)
+{
+	PIECE_COLOR enemy = (color == WHITE) ? BLACK : WHITE;
 
-					cout << piece->getColor() << " " << piece->getType()
-						 << " -> (" << piece->getColumn() << ", " << piece->getRow() << ")" << endl;
-				}
+	return getBlockers(lowestSquare(colorBB[color] & typeBB[KING]), enemy) & colorBB[color];
+}
 
-			// escapeVector - The coordinates of safe squares that the king can be moved to.
-			cout << "=====================" << endl
-				 << "escapeVector Contents" << endl << endl;
-		
-			if (escapeVector.empty())
-				cout << "No content" << endl;
-			else
-				for (int i = 0; i < escapeVector.size(); ++i)
-				{
-					std::pair<int, int> coord = escapeVector[i];
+//	Returns the pieces, of either color, that are the only piece between square and a slider of sliderColor that
+//	would otherwise reach it.
+bitboard chessBoardClass::getBlockers(int square, PIECE_COLOR sliderColor)
+{
+	bitboard sliders = (rookAttacks(square, 0) & (typeBB[ROOK] | typeBB[QUEEN]))
+		| (bishopAttacks(square, 0) & (typeBB[BISHOP] | typeBB[QUEEN]));
+	sliders &= colorBB[sliderColor];
 
-					cout << "(" << coord.first << ", " << coord.second << ")" << endl;
-				}
+	bitboard lone = 0;
 
-			cout << "========================" << endl;
-			cout << "******************************" << endl;
-		}
-		
-		return true;
+	while (sliders != 0)
+	{
+		bitboard blockers = betweenSquares(square, popLowestSquare(sliders)) & occupiedBB;
+
+		if (popCount(blockers) == 1)
+			lone |= blockers;
 	}
-	else
-		return false;
-		
+
+	return lone;
 }
 
-//	Helper function to move(), does a lot of the lower-level data handling.
-void chessBoardClass::performMove(chessPiece& piece, int destC, int destR, bool forceMove)
+//	The enemy king can be checked directly by a piece landing on one of its checkSquares, or by a discoverer moving
+//	off the line between the king and the slider behind it.
+void chessBoardClass::getCheckInfo(checkInfo& info)
 {
-	int origC = piece.getColumn(), origR = piece.getRow();
+	PIECE_COLOR enemy = (turn == WHITE) ? BLACK : WHITE;
+	int kingSquare = lowestSquare(colorBB[enemy] & typeBB[KING]);
+
+	info.kingSquare = kingSquare;
+	info.checkSquares[PAWN] = pawnAttacks(enemy, kingSquare);
+	info.checkSquares[KNIGHT] = knightAttacks(kingSquare);
+	info.checkSquares[BISHOP] = bishopAttacks(kingSquare, occupiedBB);
+	info.checkSquares[ROOK] = rookAttacks(kingSquare, occupiedBB);
+	info.checkSquares[QUEEN] = info.checkSquares[BISHOP] | info.checkSquares[ROOK];
+	info.checkSquares[KING] = 0;
+	info.discoverers = getBlockers(kingSquare, turn) & colorBB[turn];
+}
 
-	chessPiece* occupier = getSquareContents(destC, destR);
+//	Normal moves only need the two lookups.  Castling, promotions, and en passant move or remove a second piece, so
+//	they are tested against the occupancy after the move instead.
+bool chessBoardClass::givesCheck(chessMove move, const checkInfo& info)
+{
+	int from = move.getFrom(), to = move.getTo();
+	bitboard kingBit = squareBit(info.kingSquare);
 
-	// Special Movement Case:  En Passant Capture
-	// All movement tests have passed at this point.
-	if (piece.getType() == PAWN && origC != destC)
+	bool discovered = (info.discoverers & squareBit(from)) && !(lineThrough(info.kingSquare, from) & squareBit(to));
+
+	if (move.getFlag() == NORMAL_MOVE)
+		return (info.checkSquares[board[squareColumn(from)][squareRow(from)]->getType()] & squareBit(to)) || discovered;
+
+	bitboard occupied = (occupiedBB & ~squareBit(from)) | squareBit(to);
+
+	if (move.getFlag() == CASTLE_MOVE)
 	{
-		// Attack diagonal is empty, so the target must be an en-passant eligible pawn.
-		if (occupier == NULL)
-		{
-			occupier = getSquareContents(destC, origR);
-			
-			// Set board square to point to NULL, so display function doesn't 
-			// try to access an invalid memory address
-			board[destC][origR] = NULL;
-		}
-		// The rest of the function takes care of the remaining work.
+		//	The king itself can't give check, so only the rook, which lands on the square the king passed over, can.
+		int rookFrom = (to > from) ? from + 3 : from - 4;
+		int rookTo = (from + to) / 2;
+
+		occupied = (occupied & ~squareBit(rookFrom)) | squareBit(rookTo);
+
+		return (rookAttacks(rookTo, occupied) & kingBit) != 0;
 	}
 
-	// Special Movement Case:  Castling
-	// All movement tests have been performed -> just move the pieces.
-	if (piece.getType() == KING && abs(origC - destC) == 2)
+	bitboard attacks;
+
+	if (move.getFlag() == EN_PASSANT_MOVE)
 	{
-		chessPiece* rook;
-		// Castle Queen-Side
-		if (destC < origC)
-		{
-			// Grab the rook pointer from the board.
-			rook = getSquareContents(0, origR);
+		occupied &= ~squareBit(squareIndex(move.getDestC(), move.getOrigR()));
+		attacks = pawnAttacks(turn, to);
+	}
+	else if (move.getPromotion() == KNIGHT)
+		attacks = knightAttacks(to);
+	else if (move.getPromotion() == BISHOP)
+		attacks = bishopAttacks(to, occupied);
+	else if (move.getPromotion() == ROOK)
+		attacks = rookAttacks(to, occupied);
+	else
+		attacks = queenAttacks(to, occupied);
 
-			// Clear the necessary board pointers.
-			board[origC][origR] = NULL;
-			board[0][origR] = NULL;
+	if (attacks & kingBit)
+		return true;
 
-			// Set the pieces in place, sync board.
-			piece.moveTo(destC, destR);
-			board[destC][destR] = &piece;
-			rook->moveTo(destC + 1, destR);	// Queen-side castle -> rook is right of the king.
-			board[destC + 1][destR] = rook;
+	//	The sliders that were already on the board, seen through the squares the move has emptied.
+	bitboard sliders = (rookAttacks(info.kingSquare, occupied) & (typeBB[ROOK] | typeBB[QUEEN]))
+		| (bishopAttacks(info.kingSquare, occupied) & (typeBB[BISHOP] | typeBB[QUEEN]));
 
-		}
-		else // Castle King-Side
-		{
-			// Grab the rook pointer from the board.
-			rook = getSquareContents(7, origR);
+	return (sliders & colorBB[turn] & ~squareBit(from)) != 0;
+}
 
-			// Clear the necessary board pointers.
-			board[origC][origR] = NULL;
-			board[7][origR] = NULL;
+//	Returns the squares of the enemy pieces that are checking the king of the side to move.
+bitboard chessBoardClass::getCheckers()
+{
+	PIECE_COLOR enemy = (turn == WHITE) ? BLACK : WHITE;
 
-			// Set the pieces in place, sync board.
-			piece.moveTo(destC, destR);
-			board[destC][destR] = &piece;
-			rook->moveTo(destC - 1, destR);	// King-side castle -> rook is right of the king.
-			board[destC - 1][destR] = rook;
-		}
-	}
+	return attackersTo(lowestSquare(colorBB[turn] & typeBB[KING]), enemy, occupiedBB);
+}
 
-	// Vanilla Movement Case
-	// If target square is occupied, delete the occupier.
-	if (occupier != NULL)
+//	Plays out the exchange on the destination square of move without touching the board, on an occupancy bitboard alone.
+/*
+	Each side recaptures with its least valuable attacker.  Taking a piece off the occupancy uncovers any slider
+	behind it (an x-ray attacker), since the attackers are worked out again from the new occupancy each time.
+	gain[d] holds the score for the side making the d-th capture, if the exchange stopped right after it; going
+	back up the list, each side only carries on capturing if that is better than stopping.  Pins are ignored.
+*/
+int chessBoardClass::staticExchange(chessMove move)
+{
+	int from = move.getFrom(), to = move.getTo();
+	int gain[32];
+	int depth = 0;
+
+	bitboard occupied = occupiedBB;
+	int attackerValue = val.getValue(board[squareColumn(from)][squareRow(from)]->getType());
+
+	if (move.getFlag() == EN_PASSANT_MOVE)
 	{
-		occupier->setCaptured(true);
-		PIECE_COLOR color = occupier->getColor();
-		PIECE_TYPE type = occupier->getType();
+		gain[0] = val.pawn;
+		occupied ^= squareBit(squareColumn(to), squareRow(from));
+	}
+	else
+		gain[0] = (occupiedBB & squareBit(to)) ? val.getValue(board[squareColumn(to)][squareRow(to)]->getType()) : 0;
 
-		// A vector element's erase flag is set to true.
-		/* This will erase the piece from its vector so it doesn't cause problems.
-		// This is needed since deleting a pointer that is an element of a vector
-		// doesn't erase it from the vector.  Since the pin-check test in the movementLogic
-		// method below relies on copying the piece vectors into a new chessBoardClass
-		// instance, we can't be copying dangling pointers that don't actually point
-		// to anything. */
+	// A promoting pawn is worth its new piece from then on.
+	if (move.getFlag() == PROMOTION_MOVE)
+	{
+		gain[0] += val.getValue(move.getPromotion()) - val.pawn;
+		attackerValue = val.getValue(move.getPromotion());
 	}
 
-	// Move the piece to the target testination, sync the board.
-	piece.moveTo(destC, destR);
-	board[destC][destR] = &piece;
+	PIECE_COLOR side = turn;
+	bitboard attacker = squareBit(from);
 
-	// Note:	piece->moveTo() handles setting the enPassant flag or 
-	//			canCastle flag of pawn and rook/king pieces appropriately.
+	while (attacker != 0 && depth < 31)
+	{
+		++depth;
+		side = (side == WHITE) ? BLACK : WHITE;
 
-	// Original spot is empty after the move.
-	board[origC][origR] = NULL;
+		// The last piece to capture is now what's on the square.
+		gain[depth] = attackerValue - gain[depth - 1];
 
-	// Special Movement Case:  Pawn Promotion
-	if (piece.getType() == PAWN && (destR == 0 || destR == 7) && !forceMove)
-	{	
-		// Flag the pawn for erasure.
-		piece.setCaptured(true);
+		occupied ^= attacker;
 
-		// Only way for a pawn to reach row 0 (1st row) is for the pawn to be black, which means it needs to be promoted.
-		// Same thing applies to white pawns that reach row 7 (the last row).
-		pawnPromotion(piece);
+		bitboard attackers = attackersTo(to, side, occupied) & occupied;
+		attacker = 0;
 
-		PIECE_COLOR color = piece.getColor();
-		PIECE_TYPE type = piece.getType();
+		for (int type = PAWN; type <= KING; ++type)
+		{
+			bitboard candidates = attackers & typeBB[type];
 
-		// The promoted pawn needs to be deleted.
-		// cleanUpPieceVectors(color, type);
+			if (candidates != 0)
+			{
+				attacker = squareBit(lowestSquare(candidates));
+				attackerValue = val.getValue(PIECE_TYPE(type));
+				break;
+			}
+		}
 	}
 
-	return;
+	while (--depth > 0)
+		gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+
+	return gain[0];
+}
+
+//	Writes out a move from the square from to each square in targets.
+void chessBoardClass::addMoves(moveList& moves, int from, bitboard targets, MOVE_FLAG flag)
+{
+	while (targets != 0)
+		moves.add(chessMove(from, popLowestSquare(targets), flag));
+}
+
+//	Same as addMoves(), but a pawn reaching the last row is written out once for each piece it can promote to.
+void chessBoardClass::addPawnMoves(moveList& moves, int from, bitboard targets)
+{
+	const bitboard lastRows = 0xFF000000000000FFull;
+	const PIECE_TYPE promotions[4] = { QUEEN, ROOK, BISHOP, KNIGHT };
+
+	addMoves(moves, from, targets & ~lastRows);
+
+	targets &= lastRows;
+	while (targets != 0)
+	{
+		int to = popLowestSquare(targets);
+
+		for (int i = 0; i < 4; ++i)
+			moves.add(chessMove(from, to, PROMOTION_MOVE, promotions[i]));
+	}
 }
 
 ///										Multi-Test Movement Logic Notes											\\\
@@ -3359,7 +2720,8 @@ bool chessBoardClass::movementLogic(chessPiece& piece, int destC, int destR)
 			}
 
 			// Squares are clear, but are they under attack?
-			for (int tracerC = origC - 1; tracerC != 0; --tracerC)
+			// Only the two squares the king passes over matter; the third square only has to be empty for the rook.
+			for (int tracerC = origC - 1; tracerC >= origC - 2; --tracerC)
 			{
 				if (getAttackers(tracerC, origR).size() > 0)
 					return false;
@@ -3388,7 +2750,8 @@ bool chessBoardClass::movementLogic(chessPiece& piece, int destC, int destR)
 			rook = getSquareContents(7, origR);
 		}
 
-		if (rook == NULL)
+		// The corner piece has to be a friendly rook (a promoted piece may have ended up there).
+		if (rook == NULL || rook->getType() != ROOK || rook->getColor() != piece.getColor())
 			return false;
 
 		// Check for rook's castling eligibility
@@ -3434,7 +2797,11 @@ bool chessBoardClass::movementLogic(chessPiece& piece, int destC, int destR)
 
 		else // checkVector.size() == 1
 		{
-			if (piece.getType() != KING)
+			// An en passant capture of the checking pawn also takes the king out of check.
+			bool enPassantCapture = piece.getType() == PAWN && destC != piece.getColumn() && getSquareContents(destC, destR) == NULL
+				&& checkVector[0] == getSquareContents(destC, piece.getRow());
+
+			if (piece.getType() != KING && !enPassantCapture)
 			{
 				bool isSavior = false;
 
@@ -5,9 +5,16 @@
 
 #include "GlobalVars.h"
 #include "chessPieceClasses.h"
+#include "chessPiecePool.h"
+#include "chessBitboard.h"
+#include "chessZobrist.h"
+#include "chessEvaluationTables.h"
+#include <cstdint>
 #include <vector>
 #include <stack>
 #include <list>
+#include <utility>
+#include <string>
 
 
 
@@ -15,6 +22,153 @@
 //	Needed for some AI related methods, so it is kept in global space.
 enum PIN_DIR { RIGHT, UP_RIGHT, UP, UP_LEFT, LEFT, DOWN_LEFT, DOWN, DOWN_RIGHT };
 
+//	Holds everything makeMove() needs to put the board back the way it was found with unmakeMove().
+struct undoInfo
+{
+	chessPiece* piece;					// Piece that was moved.
+	int origC, origR, destC, destR;		// Original and destination movement coordinates.
+	bool pieceFlag;						// Moved piece's canCastle (rook/king) or enPassant (pawn) flag before the move.
+
+	chessPiece* captured;				// Captured piece, or NULL if the move was not a capture.
+	int capturedC, capturedR;			// Square the captured piece was on (differs from dest for en passant).
+
+	chessPiece* rook;					// Rook that was moved by castling, or NULL.
+	int rookOrigC, rookDestC;			// Rook's original and destination columns (castling stays on one row).
+
+	chessPiece* promoted;				// Piece created by pawn promotion, or NULL.
+
+	int enPassantMask;					// Bit i set if pawn i of the side to move had its enPassant flag cleared by swapTurn().
+
+	PIECE_COLOR turn;
+	positionKey zobristKey;
+	int phaseScores[2];
+	int gamePhase;
+
+	//	Bitboards of the position before the move.
+	bitboard colorBB[2];
+	bitboard typeBB[6];
+	bitboard occupiedBB;
+};
+
+//	Kinds of move that need more than the moving piece to be picked up and put down.
+enum MOVE_FLAG { NORMAL_MOVE, PROMOTION_MOVE, EN_PASSANT_MOVE, CASTLE_MOVE };
+
+//	A move packed into 16 bits, as written out by generateMoves().
+//	Bits 0-5 hold the origin square, bits 6-11 the destination square (see squareIndex()), bits 12-13 the piece a
+//	pawn promotes to (counted from KNIGHT), and bits 14-15 the MOVE_FLAG.  A value of 0 is never a legal move.
+struct chessMove
+{
+	std::uint16_t data;
+
+	chessMove() : data(0) { }
+	chessMove(int from, int to, MOVE_FLAG flag = NORMAL_MOVE, PIECE_TYPE promotion = KNIGHT)
+		: data(std::uint16_t(from | (to << 6) | ((promotion - KNIGHT) << 12) | (flag << 14))) { }
+
+	int getFrom() const { return data & 0x3F; }
+	int getTo() const { return (data >> 6) & 0x3F; }
+	MOVE_FLAG getFlag() const { return MOVE_FLAG(data >> 14); }
+	PIECE_TYPE getPromotion() const { return PIECE_TYPE(((data >> 12) & 0x3) + KNIGHT); }
+
+	int getOrigC() const { return squareColumn(getFrom()); }
+	int getOrigR() const { return squareRow(getFrom()); }
+	int getDestC() const { return squareColumn(getTo()); }
+	int getDestR() const { return squareRow(getTo()); }
+
+	//	Returns the move in long algebraic notation, such as e2e4 or e7e8q, as UCI and perft divide write it.
+	std::string toString() const
+	{
+		std::string text;
+		text += char('a' + getOrigC());
+		text += char('1' + getOrigR());
+		text += char('a' + getDestC());
+		text += char('1' + getDestR());
+
+		if (getFlag() == PROMOTION_MOVE)
+			text += "pnbrqk"[getPromotion()];
+
+		return text;
+	}
+
+	bool operator==(const chessMove& obj) const { return data == obj.data; }
+	bool operator!=(const chessMove& obj) const { return data != obj.data; }
+};
+
+//	Which of a position's legal moves generateMoves() writes out.  Captures include en passant and every promotion;
+//	quiet moves are the rest, castling included.
+enum MOVE_GEN { ALL_MOVES, CAPTURE_MOVES, QUIET_MOVES };
+
+//	Most legal moves any chess position can have.
+const int MAX_MOVES = 218;
+
+//	Fixed-size list of moves, meant to live on the stack so that the search never allocates while it walks the tree.
+//	Each move has a score, so that the moves can be handed out best first by pickNext().
+struct moveList
+{
+	chessMove moves[MAX_MOVES];
+	int scores[MAX_MOVES];
+	int count;
+
+	moveList() : count(0) { }
+
+	void add(chessMove move) { moves[count] = move; scores[count] = 0; ++count; }
+	int size() const { return count; }
+	bool empty() const { return count == 0; }
+	chessMove& operator[](int i) { return moves[i]; }
+
+	//	Swaps the best scoring move at or after index into index and returns it.  Calling this for index = 0, 1, 2...
+	//	is a selection sort that stops as soon as the search stops asking, which after a cut-off is usually very early.
+	chessMove pickNext(int index)
+	{
+		int best = index;
+		for (int i = index + 1; i < count; ++i)
+			if (scores[i] > scores[best])
+				best = i;
+
+		std::swap(moves[index], moves[best]);
+		std::swap(scores[index], scores[best]);
+
+		return moves[index];
+	}
+};
+
+//	What it takes for the side to move to check the enemy king, worked out once for a position by
+//	chessBoardClass::getCheckInfo() so that chessBoardClass::givesCheck() is a couple of lookups per move.
+struct checkInfo
+{
+	bitboard checkSquares[6];	// Squares a piece of each type, indexed by PIECE_TYPE, would give check from.
+	bitboard discoverers;		// Pieces of the side to move that are all that stands between one of its sliders and the enemy king.
+	int kingSquare;				// Square of the enemy king.
+};
+
+//	A position as plain data, with no pointers and no heap memory, so that it copies with a single memcpy and can be
+//	handed to another thread, or written out and read back, as-is.  chessBoardClass writes one out with getPosition()
+//	and sets itself up from one with setPosition(), which is also how boards are copied.
+struct chessPosition
+{
+	bitboard colorBB[2];				// Squares of each color's pieces, indexed by PIECE_COLOR.
+	bitboard typeBB[6];					// Squares of each type of piece, indexed by PIECE_TYPE.
+	positionKey zobristKey;
+	std::int16_t phaseScores[2];		// See chessBoardClass::phaseScores.
+
+	std::uint8_t squares[64];			// Piece on each square, as a pieceCode(), or EMPTY_SQUARE.
+	std::uint8_t pieceList[2][16];		// Squares of each color's pieces, in square order.
+	std::uint8_t pieceCount[2];			// Number of squares used in each pieceList.
+
+	std::uint8_t gamePhase;
+	std::uint8_t turn;					// PIECE_COLOR of the side to move.
+	std::uint8_t castleRights;			// Set of CASTLE_RIGHTS bits.
+	std::uint8_t enPassantSquare;		// Square passed over by a pawn's double step on the last move, or NO_SQUARE.
+
+	static const std::uint8_t EMPTY_SQUARE = 0xFF;
+	static const std::uint8_t NO_SQUARE = 0xFF;
+
+	static std::uint8_t pieceCode(PIECE_COLOR color, PIECE_TYPE type) { return std::uint8_t(color * 6 + type); }
+	static PIECE_COLOR codeColor(std::uint8_t code) { return PIECE_COLOR(code / 6); }
+	static PIECE_TYPE codeType(std::uint8_t code) { return PIECE_TYPE(code % 6); }
+};
+
+static_assert(sizeof(chessPosition) < 200, "chessPosition should stay small enough to copy cheaply");
+
 // chessBoardClass notes
 /*
 	The chessBoard will be implemented as a 2d array (8 x 8) of pointer-to-chessPiece.
@@ -85,21 +239,25 @@ enum PIN_DIR { RIGHT, UP_RIGHT, UP, UP_LEFT, LEFT, DOWN_LEFT, DOWN, DOWN_RIGHT }
 class chessBoardClass
 {
 protected:
-// Black vectors
-	std::vector<blackPawn> bPawns;
-	std::vector<blackKnight> bKnights;
-	std::vector<blackBishop> bBishops;
-	std::vector<blackRook> bRooks;
-	std::vector<blackQueen> bQueens;
-	std::vector<blackKing> bKing;
-
-// White vectors
-	std::vector<whitePawn> wPawns;
-	std::vector<whiteKnight> wKnights;
-	std::vector<whiteBishop> wBishops;
-	std::vector<whiteRook> wRooks;
-	std::vector<whiteQueen> wQueens;
-	std::vector<whiteKing> wKing;
+// Most pieces of one type a side can have:  all of its pawns, or its two starting pieces plus eight promoted pawns.
+	static const int maxPawns = 8;
+	static const int maxPieces = 10;
+
+// Black pools (see chessPiecePool.h)
+	piecePool<blackPawn, maxPawns> bPawns;
+	piecePool<blackKnight, maxPieces> bKnights;
+	piecePool<blackBishop, maxPieces> bBishops;
+	piecePool<blackRook, maxPieces> bRooks;
+	piecePool<blackQueen, maxPieces> bQueens;
+	piecePool<blackKing, 1> bKing;
+
+// White pools
+	piecePool<whitePawn, maxPawns> wPawns;
+	piecePool<whiteKnight, maxPieces> wKnights;
+	piecePool<whiteBishop, maxPieces> wBishops;
+	piecePool<whiteRook, maxPieces> wRooks;
+	piecePool<whiteQueen, maxPieces> wQueens;
+	piecePool<whiteKing, 1> wKing;
 
 ///	No longer needed.
 // Helper function that will erase piece vector elements that have their erase flag set to true.
@@ -137,11 +295,33 @@ protected:
 // board is an 8x8 array of pointer-to-chessPiece elements
 	chessPiece* board[numColumns][numRows];
 
+// Bitboards that mirror board[][] (see chessBitboard.h).  One set of squares per color (indexed by PIECE_COLOR),
+// one per piece type (indexed by PIECE_TYPE), and one for every occupied square.
+	bitboard colorBB[2];
+	bitboard typeBB[6];
+	bitboard occupiedBB;
+
+// Zobrist key of the position (see chessZobrist.h).  Kept up to date by addToBitboards(), removeFromBitboards(),
+// performMove(), and swapTurn().
+	positionKey zobristKey;
+
+// Material plus piece-position value of every piece on the board, white minus black, for each GAME_PHASE (see
+// chessEvaluationTables.h).  Kept up to date by addToBitboards() and removeFromBitboards().
+	int phaseScores[2];
+
+// Sum of the phaseWeights of the pieces on the board, from MAX_GAME_PHASE at the start down to 0 with only pawns
+// and kings left.  Promotions can take it past MAX_GAME_PHASE.  Kept up to date the same way as phaseScores.
+	int gamePhase;
+
 // WHITE if it's white's turn, BLACK if it's black's turn.
 	PIECE_COLOR turn;
 
 //	If a king cannot be taken out of check, then this is true.
 	bool checkmate;
+
+//	True if the board-analysis vectors (and checkmate) have not been worked out for the current position yet.
+//	makeMove() and unmakeMove() leave the analysis alone, since the search doesn't need it, and set this instead.
+	bool analysisStale;
 	
 // Piece-type dependent move logic to determine move legality.
 	bool movementLogic(chessPiece& piece, int destC, int destR);
@@ -170,22 +350,68 @@ protected:
 	std::vector<chessPiece*> getAttackers(int col, int row);
 //	Similar, but specially designed for the king to handle check conditions when attacked by minor pieces.
 	std::vector<chessPiece*> getAttackers(chessPiece* king, int col, int row);
+// Returns the squares of the pieces of the given color that attack square, with sliders blocked by occupied.
+	bitboard attackersTo(int square, PIECE_COLOR color, bitboard occupied);
+// Returns the pieces that stand on the squares in the set.
+	std::vector<chessPiece*> getPiecesOn(bitboard squares);
+// Returns the direction of (col, row) relative to (originC, originR), which must share a line.
+	PIN_DIR pinDirection(int originC, int originR, int col, int row);
+// Returns the pieces of the given color that are the only piece between their king and an enemy slider.
+	bitboard getPinned(PIECE_COLOR color);
+// Returns the pieces that are the only piece between square and a slider of sliderColor.
+	bitboard getBlockers(int square, PIECE_COLOR sliderColor);
+// Helpers for generateMoves() that write out a move for each square in targets.
+	void addMoves(moveList& moves, int from, bitboard targets, MOVE_FLAG flag = NORMAL_MOVE);
+	void addPawnMoves(moveList& moves, int from, bitboard targets);
 	
 // Helper function to swap turn indicator and clear the check, escape, and attack vectors
 	void swapTurn();
+// Helpers for makeMove() and unmakeMove() that record, and put back, the en passant flags of a color's pawns (bit i for pawn i).
+	int getEnPassantMask(PIECE_COLOR color);
+	void restoreEnPassant(PIECE_COLOR color, int mask);
 
 // Helper function that performs necessary work to complete a chess move.
-	void performMove(chessPiece& piece, int destC, int destR, bool forceMove = false);
+// promotion selects the piece a pawn is promoted to; PAWN means pawnPromotion() decides.
+	void performMove(chessPiece& piece, int destC, int destR, bool forceMove = false, PIECE_TYPE promotion = PAWN);
 
 // Helper function that will return false if a moving piece is obstructed.
 	bool isPathClear(chessPiece& piece, int destC, int destR);
 
 // Helper function that will handle pawn promotions.
-	void pawnPromotion(chessPiece& pawn);
+// If promotion is PAWN, the player is asked for the piece (or QUEEN is picked if the board is owned by the AI).
+	void pawnPromotion(chessPiece& pawn, PIECE_TYPE promotion = PAWN);
 
 // Helper function that will assist scanForPins() by finding potential pin candidates.
 	std::vector<std::pair<chessPiece*, PIN_DIR>> scanForDefenders(chessPiece& king);
 
+// Helper function that repopulates the check, escape, pin, attack, and savior vectors for the side to move,
+// and sets checkmate if needed.  Shared by move() and setTurn().
+	void updateBoardAnalysis();
+
+// Calls updateBoardAnalysis() if a makeMove() or unmakeMove() has left the analysis out of date.
+	void refreshAnalysis() { if (analysisStale) updateBoardAnalysis(); }
+
+// Helper functions that read and write the canCastle (rook and king) or enPassant (pawn) flag of a piece.
+	bool getMoveFlag(chessPiece& piece) const;
+	void setMoveFlag(chessPiece& piece, bool flag);
+
+// Helper functions that add a piece to, or remove a piece from, the bitboards (and the Zobrist key and phase scores) at (col, row).
+	void addToBitboards(PIECE_COLOR color, PIECE_TYPE type, int col, int row);
+	void removeFromBitboards(PIECE_COLOR color, PIECE_TYPE type, int col, int row);
+
+// Rebuilds the bitboards from board[][].
+	void syncBitboards();
+
+// Returns the castling rights of both sides, as a set of CASTLE_RIGHTS bits.  A right is held while the king and
+// the rook on that side are both on their starting squares with their canCastle flags set.
+	int getCastleRights() const;
+
+// Works out the Zobrist key of the position from scratch.
+	positionKey computeZobristKey();
+
+// Helper for setPosition() that adds a piece to the end of its pool and puts it on board[col][row].
+	void placePiece(PIECE_COLOR color, PIECE_TYPE type, int col, int row);
+
 
 public:
 	// Constructor
@@ -196,16 +422,70 @@ public:
 	~chessBoardClass();
 	// Sets the board and various instance variables to initial state
 	void init();
+	// Sets the board up from a position in Forsyth-Edwards Notation, such as
+	// "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1".  The move counters may be left off.
+	// Returns false, leaving the board as it was, if fen is not a legal position.
+	bool loadFEN(const std::string& fen);
+	// Returns the position in Forsyth-Edwards Notation.  The board doesn't count moves, so the halfmove clock
+	// and fullmove number are always written as 0 and 1.
+	std::string toFEN();
+	// Writes the position out as plain data (see chessPosition).
+	void getPosition(chessPosition& position) const;
+	// Sets the board up from a position written out by getPosition().  The board analysis is worked out when it is
+	// next needed.
+	void setPosition(const chessPosition& position);
 	// Moves piece at (origC, origR) to (destC, destR) if such a move is legal.
 	bool move(int origC, int origR, int destC, int destR, bool noMove = false, bool forceMove = false);
 	// Returns the address of the piece at coordinates (c, r), or NULL if no piece is present.
 	chessPiece* getSquareContents(int c, int r);
 
+	// Performs a move that is already known to be legal, recording what is needed to take it back in undo.
+	// Used by the AI search in place of copying the whole board for every node.
+	void makeMove(int origC, int origR, int destC, int destR, undoInfo& undo, PIECE_TYPE promotion = QUEEN);
+	void makeMove(chessMove move, undoInfo& undo);
+	// Takes back a move made with makeMove().  Moves must be taken back in the reverse order they were made.
+	void unmakeMove(undoInfo& undo);
+	// Passes the turn to the other side without moving anything, for null-move pruning.  Must not be used in check.
+	void makeNullMove(undoInfo& undo);
+	// Takes back a move made with makeNullMove().
+	void unmakeNullMove(undoInfo& undo);
+	// Appends every legal move for the side to move to moves, returning how many there are.
+	// With capturesOnly set, only captures and promotions are written out.
+	int generateMoves(moveList& moves, bool capturesOnly = false) { return generateMoves(moves, capturesOnly ? CAPTURE_MOVES : ALL_MOVES); }
+	// Appends the legal moves of one kind, made by the pieces standing on fromSquares, returning how many there are.
+	int generateMoves(moveList& moves, MOVE_GEN kind, bitboard fromSquares = ~bitboard(0));
+
+	// Fills info in for the position, for givesCheck().
+	void getCheckInfo(checkInfo& info);
+	// Returns true if the legal move move would put the enemy king in check.  info must be for the current position.
+	bool givesCheck(chessMove move, const checkInfo& info);
+
+	// Returns true if move is a legal move for the side to move, written out the way generateMoves() would write it.
+	// Meant for moves remembered from other positions, such as the transposition table's best move or a killer.
+	bool isLegal(chessMove move);
+
 	// Returns true if the game is over.
-	bool getCheckmate() { return checkmate; }
+	bool getCheckmate() { refreshAnalysis(); return checkmate; }
 
 	// Returns true if the king is in check.
-	bool getCheck() { return checkVector.size() > 0; }
+	bool getCheck() { return getCheckers() != 0; }
+
+	// Returns the squares of the enemy pieces that are checking the king of the side to move.
+	bitboard getCheckers();
+
+	// Static exchange evaluation:  Returns the material the side to move comes out ahead (or behind) if move is played
+	// and both sides then keep capturing on its destination square, cheapest piece first, for as long as it pays.
+	int staticExchange(chessMove move);
+
+	// Returns the Zobrist key of the position.  Positions that are the same (piece placement, side to move, castling
+	// rights, and en passant) have the same key, however they were reached.
+	positionKey getZobristKey() const { return zobristKey; }
+
+	// Returns the material plus piece-position value of the board for a phase of the game, from white's point of view.
+	int getPhaseScore(GAME_PHASE phase) const { return phaseScores[phase]; }
+
+	// Returns how far the game is from the endgame, as the sum of the phaseWeights of the pieces on the board.
+	int getGamePhase() const { return gamePhase; }
 
 	//	Returns true if the object has been created by an AI.
 	bool getAI() { return ownedByAI; }
@@ -220,31 +500,37 @@ public:
 
 	void operator=(const chessBoardClass& obj);
 
-	//	Accessor methods that return points to the various piece vectors.
+	//	Accessor methods that return pointers to the various piece pools.
 	
 	//	Black piece accessor methods.
-	std::vector<blackPawn>* getBlackPawns() { return &bPawns; }
-	std::vector<blackKnight>* getBlackKnights() { return &bKnights; }
-	std::vector<blackBishop>* getBlackBishops() { return &bBishops; }
-	std::vector<blackRook>* getBlackRooks() { return &bRooks; }
-	std::vector<blackQueen>* getBlackQueens() { return &bQueens; }
-	std::vector<blackKing>* getBlackKing() { return &bKing; }
+	piecePool<blackPawn, maxPawns>* getBlackPawns() { return &bPawns; }
+	piecePool<blackKnight, maxPieces>* getBlackKnights() { return &bKnights; }
+	piecePool<blackBishop, maxPieces>* getBlackBishops() { return &bBishops; }
+	piecePool<blackRook, maxPieces>* getBlackRooks() { return &bRooks; }
+	piecePool<blackQueen, maxPieces>* getBlackQueens() { return &bQueens; }
+	piecePool<blackKing, 1>* getBlackKing() { return &bKing; }
 
 	//	White piece accessor methods.
-	std::vector<whitePawn>* getWhitePawns() { return &wPawns; }
-	std::vector<whiteKnight>* getWhiteKnights() { return &wKnights; }
-	std::vector<whiteBishop>* getWhiteBishops() { return &wBishops; }
-	std::vector<whiteRook>* getWhiteRooks() { return &wRooks; }
-	std::vector<whiteQueen>* getWhiteQueens() { return &wQueens; }
-	std::vector<whiteKing>* getWhiteKing() { return &wKing; }
+	piecePool<whitePawn, maxPawns>* getWhitePawns() { return &wPawns; }
+	piecePool<whiteKnight, maxPieces>* getWhiteKnights() { return &wKnights; }
+	piecePool<whiteBishop, maxPieces>* getWhiteBishops() { return &wBishops; }
+	piecePool<whiteRook, maxPieces>* getWhiteRooks() { return &wRooks; }
+	piecePool<whiteQueen, maxPieces>* getWhiteQueens() { return &wQueens; }
+	piecePool<whiteKing, 1>* getWhiteKing() { return &wKing; }
+
+	//	Bitboard accessor methods.  Pieces of a color, pieces of a type, pieces of a color and type, and all pieces.
+	bitboard getPieces(PIECE_COLOR c) const { return colorBB[c]; }
+	bitboard getPieces(PIECE_TYPE t) const { return typeBB[t]; }
+	bitboard getPieces(PIECE_COLOR c, PIECE_TYPE t) const { return colorBB[c] & typeBB[t]; }
+	bitboard getOccupied() const { return occupiedBB; }
 
 	//	Get board-analysis vectors
-	std::vector<chessPiece*>* getCheckVector() { return &checkVector; }
-	std::vector<std::pair<int, int>>* getEscapeVector() { return &escapeVector; }
-	std::vector<std::pair<int, int>>* getAttackVector() { return &attackVector; }
-	std::vector<chessPiece*>* getSaviorVector() { return &saviorVector; }
-	std::vector<std::pair<std::pair<chessPiece*, chessPiece*>, PIN_DIR>>* getPinVector() { return &pinVector; }
-	std::vector<std::pair<chessPiece*, PIN_DIR>>* getDefenderVector() { return &defenderVector; }
+	std::vector<chessPiece*>* getCheckVector() { refreshAnalysis(); return &checkVector; }
+	std::vector<std::pair<int, int>>* getEscapeVector() { refreshAnalysis(); return &escapeVector; }
+	std::vector<std::pair<int, int>>* getAttackVector() { refreshAnalysis(); return &attackVector; }
+	std::vector<chessPiece*>* getSaviorVector() { refreshAnalysis(); return &saviorVector; }
+	std::vector<std::pair<std::pair<chessPiece*, chessPiece*>, PIN_DIR>>* getPinVector() { refreshAnalysis(); return &pinVector; }
+	std::vector<std::pair<chessPiece*, PIN_DIR>>* getDefenderVector() { refreshAnalysis(); return &defenderVector; }
 
 };
 
@@ -0,0 +1,32 @@
+#include "chessEvaluationTables.h"
+#include "chessBitboard.h"
+
+int pieceSquareScores[2][2][6][64];
+
+static bool scoresReady = false;
+
+void initPieceSquareScores()
+{
+	if (scoresReady)
+		return;
+
+	const int (*tables[6])[8] = { pawnPosValue, knightPosValue, bishopPosValue, rookPosValue, queenPosValue, kingPosValue_MID };
+
+	for (int phase = MIDGAME; phase <= ENDGAME; ++phase)
+		for (int type = PAWN; type <= KING; ++type)
+		{
+			const int (*table)[8] = (type == KING && phase == ENDGAME) ? kingPosValue_END : tables[type];
+			int material = (type == KING) ? 0 : val.getValue(PIECE_TYPE(type));
+
+			for (int square = 0; square < 64; ++square)
+			{
+				int col = squareColumn(square), row = squareRow(square);
+
+				//	The tables are written from white's side of the board, so white reads them upside down (see chessGameTree.h).
+				pieceSquareScores[phase][WHITE][type][square] = material + table[7 - row][col];
+				pieceSquareScores[phase][BLACK][type][square] = -(material + table[row][col]);
+			}
+		}
+
+	scoresReady = true;
+}
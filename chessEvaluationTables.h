@@ -0,0 +1,132 @@
+#pragma once
+
+#ifndef CHESS_EVALUATION_TABLES_
+#define CHESS_EVALUATION_TABLES_
+
+#include "chessPieceClasses.h"
+
+//	====== Evaluation Table Notes ======
+/*
+	The piece values and piece-position tables the AI evaluates positions with (see the notes in chessGameTree.h).
+	They live here, rather than with the AI, so that chessBoardClass can keep a running total of them as pieces are
+	added to and taken off of the board.  An evaluation then only has to read the total, instead of going over every
+	piece.
+
+	pieceSquareScores folds a piece's value and its positional value on a square into one number.  The king has no
+	material value here, only a positional one.  Only the king's table changes in the endgame, so that is all the
+	two phases differ by.
+
+	Rather than switching from one phase to the other all at once, a position is scored as a blend of the two.  Each
+	piece other than a pawn or king adds its phaseWeight to a game phase counter, which starts at MAX_GAME_PHASE and
+	falls as pieces come off; the middlegame score counts for phase / MAX_GAME_PHASE of the total, and the endgame
+	score for the rest.  Trading a piece then moves the evaluation a little, instead of making it jump.
+*/
+
+//	Contains pure, standard piece values, independent of position.
+const struct pieceValues
+{
+	int pawn = 100;
+	int knight = 300;
+	int bishop = 300;
+	int rook = 500;
+	int queen = 900;
+	int king = 100000;	// Might not be needed, but included for consistency's sake.
+
+	//	Returns the value of a piece of the given type.
+	int getValue(PIECE_TYPE type) const
+	{
+		switch (type)
+		{
+		case PAWN:		return pawn;
+		case KNIGHT:	return knight;
+		case BISHOP:	return bishop;
+		case ROOK:		return rook;
+		case QUEEN:		return queen;
+		default:		return king;
+		}
+	}
+} val;
+
+//	Below are the positional values for each piece type.  They are used for evaluating the quality of a sequence of moves, based on the strength of the piece positions.
+const int pawnPosValue[8][8] = { 0,  0,  0,  0,  0,  0,  0,  0,
+								50, 50, 50, 50, 50, 50, 50, 50,
+								10, 10, 20, 30, 30, 20, 10, 10,
+								5,  5, 10, 25, 25, 10,  5,  5,
+								0,  0,  0, 20, 20,  0,  0,  0,
+								5, -5,-10,  0,  0,-10, -5,  5,
+								5, 10, 10,-20,-20, 10, 10,  5,
+								0,  0,  0,  0,  0,  0,  0,  0 };
+
+const int knightPosValue[8][8] = {	-50,-40,-30,-30,-30,-30,-40,-50,
+									-40,-20,  0,  0,  0,  0,-20,-40,
+									-30,  0, 10, 15, 15, 10,  0,-30,
+									-30,  5, 15, 20, 20, 15,  5,-30,
+									-30,  0, 15, 20, 20, 15,  0,-30,
+									-30,  5, 10, 15, 15, 10,  5,-30,
+									-40,-20,  0,  5,  5,  0,-20,-40,
+									-50,-40,-30,-30,-30,-30,-40,-50 };
+
+const int bishopPosValue[8][8] = {	-20,-10,-10,-10,-10,-10,-10,-20,
+									-10,  0,  0,  0,  0,  0,  0,-10,
+									-10,  0,  5, 10, 10,  5,  0,-10,
+									-10,  5,  5, 10, 10,  5,  5,-10,
+									-10,  0, 10, 10, 10, 10,  0,-10,
+									-10, 10, 10, 10, 10, 10, 10,-10,
+									-10,  5,  0,  0,  0,  0,  5,-10,
+									-20,-10,-10,-10,-10,-10,-10,-20 };
+
+const int rookPosValue[8][8] = {	0,  0,  0,  0,  0,  0,  0,  0,
+									5, 10, 10, 10, 10, 10, 10,  5,
+								   -5,  0,  0,  0,  0,  0,  0, -5,
+								   -5,  0,  0,  0,  0,  0,  0, -5,
+								   -5,  0,  0,  0,  0,  0,  0, -5,
+								   -5,  0,  0,  0,  0,  0,  0, -5,
+								   -5,  0,  0,  0,  0,  0,  0, -5,
+									0,  0,  0,  5,  5,  0,  0,  0 };
+
+const int queenPosValue[8][8] = {	-20,-10,-10, -5, -5,-10,-10,-20,
+									-10,  0,  0,  0,  0,  0,  0,-10,
+									-10,  0,  5,  5,  5,  5,  0,-10,
+									-5,  0,  5,  5,  5,  5,  0, -5,
+									 0,  0,  5,  5,  5,  5,  0, -5,
+									-10,  5,  5,  5,  5,  5,  0,-10,
+									-10,  0,  5,  0,  0,  0,  0,-10,
+									-20,-10,-10, -5, -5,-10,-10,-20 };
+
+
+const int kingPosValue_MID[8][8] = {	-30,-40,-40,-50,-50,-40,-40,-30,
+										-30,-40,-40,-50,-50,-40,-40,-30,
+										-30,-40,-40,-50,-50,-40,-40,-30,
+										-30,-40,-40,-50,-50,-40,-40,-30,
+										-20,-30,-30,-40,-40,-30,-30,-20,
+										-10,-20,-20,-20,-20,-20,-20,-10,
+										 20, 20,  0,  0,  0,  0, 20, 20,
+										 20, 30, 10,  0,  0, 10, 30, 20 };
+
+//	King positional values change during the end game to encourage the AI to move the king up the board to support in pawn promotion.
+const int kingPosValue_END[8][8] = {	-50,-40,-30,-20,-20,-30,-40,-50,
+										-30,-20,-10,  0,  0,-10,-20,-30,
+										-30,-10, 20, 30, 30, 20,-10,-30,
+										-30,-10, 30, 40, 40, 30,-10,-30,
+										-30,-10, 30, 40, 40, 30,-10,-30,
+										-30,-10, 20, 30, 30, 20,-10,-30,
+										-30,-30,  0,  0,  0,  0,-30,-30,
+										-50,-30,-30,-30,-30,-30,-30,-50 };
+
+
+//	The two sets of tables a position can be evaluated with.
+enum GAME_PHASE { MIDGAME, ENDGAME };
+
+//	How much each piece type counts toward the game phase, indexed by PIECE_TYPE.
+const int phaseWeights[6] = { 0, 1, 1, 2, 4, 0 };
+
+//	Game phase of the starting position, which is as far from the endgame as a position can be.
+const int MAX_GAME_PHASE = 24;
+
+//	Indexed by GAME_PHASE, PIECE_COLOR, PIECE_TYPE, and square.  Positive for white, negative for black.
+extern int pieceSquareScores[2][2][6][64];
+
+//	Fills in pieceSquareScores from the tables above.  Safe to call more than once.
+void initPieceSquareScores();
+
+#endif
@@ -1,5 +1,6 @@
 #include "chessAI.h"
 #include <iostream>
+#include <climits>
 
 static int totalABMaxCalls = 0;
 static int totalABMinCalls = 0;
@@ -70,7 +71,7 @@ gameStateNode::~gameStateNode()
 */
 
 //	Constructor for chessGameTree, sets the root gameStateNode's board to be equal to the passed board.
-chessGameTree::chessGameTree(chessBoardClass& board, int maxD)
+chessGameTree::chessGameTree(chessBoardClass& board, int maxD, int hashMB) : table(hashMB)
 {
 	root = new gameStateNode();
 
@@ -86,6 +87,15 @@ chessGameTree::chessGameTree(chessBoardClass& board, int maxD)
 
 	currentGameState = root;
 	maxDepth = maxD;
+	nodeCount = 0;
+	threadCount = 1;
+
+	softLimit = 0;
+	hardLimit = 0;
+	stopSearch = false;
+	stopRequested = false;
+	nodeLimit = 0;
+	completedDepth = 0;
 }
 
 //	Destructor for chessGameTree - calls cleanUpTree with a follow-up delete on the root.
@@ -124,1996 +134,938 @@ void chessGameTree::cleanUpTree(gameStateNode*& node, bool destroyAll)
 	===========================================
 */
 
-action chessGameTree::findBestMove(bool isMaxPlayer)
+//	negamax always scores from the point of view of the side to move, so which player the AI is doesn't matter.
+action chessGameTree::findBestMove(bool /*isMaxPlayer*/)
+{
+	searchLimits limits;
+	limits.depth = maxDepth;
+
+	return findBestMove(limits);
+}
+
+action chessGameTree::findBestMove(const searchLimits& limits)
 {
 	gameStateNode* node = this->getCurrentNode();
 
-	int color;
+	//	Each thread does its whole search on its own board, by making and unmaking moves.
+	searchWorker main;
+	main.board = node->gameState;
 
-	if (node->isMaxNode)
-		color = 1;
-	else
-		color = -1;
+	searchStart = std::chrono::steady_clock::now();
+	setTimeLimits(limits);
 
-	int rootScore = negamax(node, -100000000, 100000000, maxDepth, color);
+	table.newSearch();
+	nodeCount = 0;
+	nodeLimit = limits.nodes;
+	stopSearch = false;
+	completedDepth = 0;
 
-	return node->bestAction;
-}
+	//	With only a clock (or a node count, or nothing at all) to go by, the search keeps going deeper until told to stop.
+	const int deepestIteration = MAX_PLY - 1;
+	bool unbounded = (softLimit > 0 || nodeLimit > 0 || limits.infinite);
+	int depthLimit = (limits.depth > 0) ? limits.depth : (unbounded ? deepestIteration : maxDepth);
 
-// Generates the game tree, returning the alpha-beta value for determining the best move.
-int chessGameTree::negamax(gameStateNode* node, int alpha, int beta, int remainingDepth, int color)
-{
-	//	Uses a variation of the minimax algorithm, utilizing alpha-beta pruning, to build and analyze the game-tree 
-	//	to a certain depth relative to currentState's depth, returning the best move in the form of an action struct.
+	//	Lazy SMP:  The helpers search the same position without talking to each other.  What they find goes into the
+	//	transposition table, where the main thread picks it up as move ordering and cut-offs.
+	std::vector<searchWorker> helpers(threadCount - 1);
+	std::vector<std::thread> threads;
 
-	//	Terminal node!
-	if (node->gameState.getCheckmate() == true)
+	for (int i = 0; i < (int)helpers.size(); ++i)
 	{
-		return -color * INT_MAX;
-	}
-			
-	
-	//	Return board evaluation value.
-	if (remainingDepth == 0 && (maxDepth % 2) == 1)
-	{
-		return color * evaluatePosition(node);	//	Not entirely sure why, but AI performance is better with this when the difficulty is set to an odd number.
-	}
-	else if (remainingDepth == 0 && (maxDepth % 2) == 0)
-	{
-		return -color * evaluatePosition(node);	//	This causes AI performance to increase when difficulty is set to an even number.
+		helpers[i].board = node->gameState;
+		helpers[i].id = i + 1;
+		threads.push_back(std::thread(&chessGameTree::helperSearch, this, std::ref(helpers[i]), depthLimit));
 	}
 
-		
-	///	GENERATE ALL POSSIBLE MOVES AND ORDER THEM FROM MOST PROMISING TO LEAST PROMISING.
-	node->actionList = generateActionList(node);
+	chessMove bestMove;
 
-	if (node->actionList.size() == 0)
+	//	Each iteration leaves its best moves in the transposition table, so the next one searches them first.
+	for (int depth = 1; depth <= depthLimit; ++depth)
 	{
-		std::cout << "DEBUG:: NO ACTIONS HAVE BEEN GENERATED!" << std::endl;
-
-		node->actionList = generateActionList(node);
-	}
+		main.rootMove = chessMove();
 
-	//	If generateActionList isn't able to generate valid actions, a placeholder action is pushed onto the stack.
-	//	The stack is used as a message carrier to notify the AI that a draw has occured as a result of the move sequence.
-	if (node->actionList.top()->bestCategory == action::DRAW)
-	{
-		return 0;
-	}
-	
-	int bestScore = INT_MIN;
+		int score = negamax(main, -MATE, MATE, depth, 0);
 
-	int score;
+		//	An iteration cut short by the clock may not have looked at its best move yet, so only finished ones count.
+		if (stopSearch)
+			break;
 
-	static int noCutOff = 0;
-	static int cutOff = 0;
-	static int totalMoves = 0;
+		bestMove = main.rootMove;
+		completedDepth = depth;
 
-	totalMoves += node->actionList.size();
+		std::uint64_t nodes = main.nodeCount;
+		for (int i = 0; i < (int)helpers.size(); ++i)
+			nodes += helpers[i].nodeCount;
 
-	while (!node->actionList.empty())
-	{
-		/// GENERATE GAMESTATE NODE FOR NEXT MOST PROMISING MOVE.
-		gameStateNode* childNode = generateChildNode(node, node->actionList.top());
+		reportIteration(depth, score, bestMove, nodes, getElapsedTime());
 
-		//	Generate a new game state for each action.
-		if (childNode != NULL)
-			node->next.push(childNode);
+		//	An iteration takes several times longer than the one before it, so one started this late wouldn't finish.
+		if (softLimit > 0 && getElapsedTime() >= softLimit)
+			break;
+	}
 
-		if (childNode == NULL)
-		{
-			action& actionData = *node->actionList.top();
+	//	The helpers stop with the main thread.
+	stopSearch = true;
 
-			//	Try the action again so we can trace the bug.
-			childNode = generateChildNode(node, node->actionList.top());
+	for (int i = 0; i < (int)threads.size(); ++i)
+		threads[i].join();
 
-			std::cout << "Next child to evaluate is NULL!!!" << std::endl;
+	nodeCount = main.nodeCount;
+	for (int i = 0; i < (int)helpers.size(); ++i)
+		nodeCount += helpers[i].nodeCount;
 
-			std::cout << "Action Data: ";
+	//	No move means the game is already over; the last action is left as it was.
+	if (bestMove == chessMove())
+		return node->bestAction;
 
-			if (actionData.piece->getColor() == WHITE)
-				std::cout << "WHITE ";
-			else
-				std::cout << "BLACK ";
+	action::MOVE_TYPE category;
+	int heuristic = evaluateHeuristic(main.board, bestMove, category);
 
-			switch (actionData.piece->getType())
-			{
-			case PAWN:
-				std::cout << "PAWN:\t";
-				break;
-			case KNIGHT:
-				std::cout << "KNIGHT:\t";
-				break;
-			case BISHOP:
-				std::cout << "BISHOP:\t";
-				break;
-			case ROOK:
-				std::cout << "ROOK:\t";
-				break;
-			case QUEEN:
-				std::cout << "QUEEN:\t";
-				break;
-			case KING:
-				std::cout << "KING:\t";
-			}
+	//	The action's piece points into the node's board, since the search board is about to go away.
+	node->bestAction = action(node->gameState.getSquareContents(bestMove.getOrigC(), bestMove.getOrigR()),
+		bestMove.getOrigC(), bestMove.getOrigR(), bestMove.getDestC(), bestMove.getDestR(), heuristic);
 
-			std::cout << "(" << actionData.origC << ", " << actionData.origR << ") -> "
-				<< "(" << actionData.destC << ", " << actionData.destR << ").\n" << std::endl;
-		}
+	return node->bestAction;
+}
 
-		///	RECURSE DOWN THE GAME TREE
-		score = -negamax(node->next.top(), -beta, -alpha, remainingDepth - 1, -color);
+//	Splits the time the search may use into a soft limit, after which no new iteration is started, and a hard limit,
+//	after which the iteration being searched is abandoned.
+void chessGameTree::setTimeLimits(const searchLimits& limits)
+{
+	softLimit = 0;
+	hardLimit = 0;
 
-		/// IF THE GENERATED MOVES THAT LEAD TO LEAF NODE ARE BETTER THAN CURRENT BEST MOVE, UPDATE THE CURRENT BEST MOVE AND ALPHA VALUE.
-		if (score > alpha)
-		{
-			node->bestAction = *node->actionList.top();
-			alpha = score;
-		}
+	if (limits.moveTime > 0)
+	{
+		softLimit = limits.moveTime;
+		hardLimit = limits.moveTime;
+		return;
+	}
 
-		delete node->actionList.top();
-		node->actionList.pop();
-		delete node->next.top();
-		node->next.pop();
+	if (limits.timeLeft <= 0)
+		return;
 
-		///	IF THE LEAF NODE SCORED LARGER THAN THE BETA VALUE, STOP SEARCHING.
-		if (score >= beta)
-		{
-			cutOff++;
-			//std::cout << "\n\nDEBUG:: CUT-OFF VALUE = " << cutOff << "\n\n" << std::endl;
-			return beta;		// Beta cut-off
-		}
+	//	Some time is held back for getting the move to the clock once the search is over.
+	const long long moveOverhead = 30;
+	long long available = std::max(limits.timeLeft - moveOverhead, 1LL);
 
-		
-	}
+	//	Without a time control to reach, the clock is shared out as if there were always this many moves left to play.
+	const int suddenDeathMoves = 30;
+	long long movesLeft = (limits.movesToGo > 0) ? limits.movesToGo : suddenDeathMoves;
 
-	//std::cout << "\n\nDEBUG:: NO CUT-OFF VALUE = " << noCutOff << "\n\n" << std::endl;
-	//std::cout << "\n\nDEBUG:: CUT-OFF VALUE = " << cutOff << "\n\n" << std::endl;
-	//std::cout << "\n\nDEBUG:: TOTAL MOVES = " << totalMoves << "\n\n" << std::endl;
+	softLimit = available / movesLeft + limits.increment * 3 / 4;
 
-	return alpha;
+	//	A search that is about to find something is given more room, but never so much that one move eats the clock.
+	hardLimit = std::min(softLimit * 4, std::max(available / 3, softLimit));
+	hardLimit = std::min(hardLimit, available);
+	softLimit = std::max(std::min(softLimit, hardLimit), 1LL);
+	hardLimit = std::max(hardLimit, 1LL);
 }
 
-/*
-	=========================================
-	Game Tree Construction - Worker Functions
-	=========================================
-*/
-
-gameStateNode* chessGameTree::generateChildNode(gameStateNode* node, action* actionData)
+// Searches the game tree, returning the alpha-beta value for determining the best move.
+int chessGameTree::negamax(searchWorker& worker, int alpha, int beta, int remainingDepth, int ply)
 {
-	gameStateNode* child = new gameStateNode(node);
+	//	Uses a variation of the minimax algorithm, utilizing alpha-beta pruning, to search the game-tree 
+	//	to a certain depth relative to currentState's depth, leaving the best move of the root in the worker's rootMove.
+
+	chessBoardClass& board = worker.board;
+
+	if (visitNode(worker))
+		return 0;
 
-	//for (std::list<action*>::iterator itr = node->moveHistory.begin(); itr != node->moveHistory.end(); ++itr)
-	//	child->moveHistory.push_back((*itr));	
+	//	Return board evaluation value, once the captures left on the board have been played out.
+	if (remainingDepth <= 0)
+		return quiescence(worker, alpha, beta, ply);
 
-	//child->gameState = node->gameState;
+	///	LOOK THE POSITION UP IN THE TRANSPOSITION TABLE.
+	//	A deep enough earlier search of this position may settle it without searching again.  The root is always
+	//	searched, since it has to come up with a move to play.
+	positionKey key = board.getZobristKey();
+	ttEntry entry;
+	chessMove hashMove;
 
-	/*	Catch up child's game state to the current game state.
-	for (std::list<action*>::iterator itr = child->moveHistory.begin(); itr != child->moveHistory.end(); ++itr)
+	if (table.probe(key, entry, ply))
 	{
-	int origC = (*itr)->origC, origR = (*itr)->origR;
-	int destC = (*itr)->destC, destR = (*itr)->destR;
+		hashMove = entry.move;
 
-	child->gameState.move(origC, origR, destC, destR);
+		if (ply > 0 && entry.depth >= remainingDepth)
+		{
+			if (entry.bound == EXACT_BOUND)
+				return entry.score;
+			if (entry.bound == LOWER_BOUND && entry.score >= beta)
+				return beta;
+			if (entry.bound == UPPER_BOUND && entry.score <= alpha)
+				return alpha;
+		}
 	}
-	*/
 
-	//for (std::list<action*>::iterator itr = child->moveHistory.begin(); itr != child->moveHistory.end(); ++itr)
-	//	child->gameState.move((*itr)->origC, (*itr)->origR, (*itr)->destC, (*itr)->destR, false, true);
+	bool inCheck = board.getCheck();
 
-	if (node->isMaxNode)
-		child->gameState.setTurn(WHITE);
-	else
-		child->gameState.setTurn(BLACK);
+	///	NULL-MOVE PRUNING.
+	//	If passing the turn still leaves a shallower search above beta, a real move would too, so the node is cut off.
+	//	Passing is never legal in check, is only tried once in a row, and is left out when the side to move has only
+	//	pawns, since those are the endings where having to move can be the worst thing that happens (zugzwang).
+	PIECE_COLOR side = board.getTurn();
+	bitboard nonPawnMaterial = board.getPieces(side, KNIGHT) | board.getPieces(side, BISHOP)
+		| board.getPieces(side, ROOK) | board.getPieces(side, QUEEN);
 
-	//	If the move is valid, create a child for the move.  Safeguard against invalid actions.
-	if (child->gameState.move(actionData->origC, actionData->origR, actionData->destC, actionData->destR, true))
-		child->gameState.move(actionData->origC, actionData->origR, actionData->destC, actionData->destR);
-	else
+	if (ply > 0 && !inCheck && remainingDepth >= 3 && nonPawnMaterial != 0 && worker.currentMoves[ply - 1] != chessMove()
+		&& evaluatePosition(board) >= beta)
 	{
-		delete child;
-		return NULL;
-	}
+		int reduction = (remainingDepth > 6) ? 3 : 2;
 
-	child->moveHistory.push_back(actionData);
+		undoInfo undo;
+		board.makeNullMove(undo);
+		worker.currentMoves[ply] = chessMove();
 
-	child->markedForDelete = true;
+		int nullScore = -negamax(worker, -beta, -beta + 1, remainingDepth - 1 - reduction, ply + 1);
 
-	child->depthLevel = node->depthLevel + 1;
+		board.unmakeNullMove(undo);
 
-	child->isMaxNode = !node->isMaxNode;
-	child->isMinNode = !node->isMinNode;
+		if (stopSearch)
+			return 0;
 
-	child->previous = node;
+		if (nullScore >= beta)
+			return beta;
+	}
 
-	return child;
-}
+	///	HAND OUT THE MOVES FROM MOST PROMISING TO LEAST PROMISING.
+	//	The picker lives on the stack, so nothing is allocated for a node, and it only writes out moves as they are needed.
+	movePicker picker(*this, worker, ply, remainingDepth, hashMove);
 
-// Populates the a vector of valid actions, sorts the vector in descending order (by heuristic value), and returns it.
-std::stack<action*> chessGameTree::generateActionList(gameStateNode* node)
-{
-	std::vector<action*> actions;
+	int score;
+	int originalAlpha = alpha;
+	chessMove bestMove;
+	chessMove move;
+	int moveCount = 0;
 
-	// Max node == white player
-	if (node->isMaxNode)
-	{
-		// Set pointers to various piece vectors for easy access.
-		std::vector<whitePawn>* pawns = node->gameState.getWhitePawns();
-		std::vector<whiteKnight>* knights = node->gameState.getWhiteKnights();
-		std::vector<whiteBishop>* bishops = node->gameState.getWhiteBishops();
-		std::vector<whiteRook>* rooks = node->gameState.getWhiteRooks();
-		std::vector<whiteQueen>* queens = node->gameState.getWhiteQueens();
-		std::vector<whiteKing>* king = node->gameState.getWhiteKing();
-
-		// Push valid moves into the actionList.
-		for (int i = 0; i < pawns->size(); ++i)
-			buildActions(node, (*pawns)[i], actions);
-		for (int i = 0; i < knights->size(); ++i)
-			buildActions(node, (*knights)[i], actions);
-		for (int i = 0; i < bishops->size(); ++i)
-			buildActions(node, (*bishops)[i], actions);
-		for (int i = 0; i < rooks->size(); ++i)
-			buildActions(node, (*rooks)[i], actions);
-		for (int i = 0; i < queens->size(); ++i)
-			buildActions(node, (*queens)[i], actions);
-
-		buildActions(node, (*king)[0], actions);
-	}
-	else // (node->isMinNode)
+	while (picker.next(move))
 	{
-		// Set pointers to various piece vectors for easy access.
-		std::vector<blackPawn>* pawns = node->gameState.getBlackPawns();
-		std::vector<blackKnight>* knights = node->gameState.getBlackKnights();
-		std::vector<blackBishop>* bishops = node->gameState.getBlackBishops();
-		std::vector<blackRook>* rooks = node->gameState.getBlackRooks();
-		std::vector<blackQueen>* queens = node->gameState.getBlackQueens();
-		std::vector<blackKing>* king = node->gameState.getBlackKing();
-
-		// Push valid moves into the actionList.
-		for (int i = 0; i < pawns->size(); ++i)
-			buildActions(node, (*pawns)[i], actions);
-		for (int i = 0; i < knights->size(); ++i)
-			buildActions(node, (*knights)[i], actions);
-		for (int i = 0; i < bishops->size(); ++i)
-			buildActions(node, (*bishops)[i], actions);
-		for (int i = 0; i < rooks->size(); ++i)
-			buildActions(node, (*rooks)[i], actions);
-		for (int i = 0; i < queens->size(); ++i)
-			buildActions(node, (*queens)[i], actions);
-
-		buildActions(node, (*king)[0], actions);
-	}
+		int i = moveCount++;
 
-	// Now that we have our actions, we need to break them up and organize them into separate storage containers.
-	std::list<action*> backwardActions;
-	std::list<action*> forwardActions;
-	std::list<action*> checkActions;
-	std::list<action*> doubleCheckActions;
-	std::list<action*> castleActions;
-	std::list<action*> captureActions;
-	std::list<action*> promotionActions;
-
-	//	Organize actions based on their best quality, where...
-	//  backwardActions < forwardActions < checkActions < doubleCheckActions < castleActions < captureActions < promotionActions
-	while (!actions.empty())
-	{
-		action::MOVE_TYPE maxMoveType = action::BACKWARD;
+		/// PLAY THE NEXT MOST PROMISING MOVE ON THE BOARD.
+		undoInfo undo;
+		board.makeMove(move, undo);
+		worker.currentMoves[ply] = move;
+
+		bool quiet = (undo.captured == NULL && move.getFlag() != PROMOTION_MOVE);
 
-		for (std::list<action::MOVE_TYPE>::iterator itr = actions.back()->moveTypeList.begin(); itr != actions.back()->moveTypeList.end(); ++itr)
+		///	RECURSE DOWN THE GAME TREE
+		//	Principal variation search:  The first move is expected to be the best, so the others only have to be shown
+		//	to be no better, which a null window around alpha does more cheaply.  One that turns out better is searched again.
+		if (i == 0)
+			score = -negamax(worker, -beta, -alpha, remainingDepth - 1, ply + 1);
+		else
 		{
-			if (maxMoveType < (*itr))
-				maxMoveType = (*itr);
-		}
+			//	Late move reductions:  Quiet moves this far down the ordering rarely turn out best, so they are searched
+			//	less deeply, and only searched to full depth if they surprise.
+			int reduction = 0;
 
-		actions.back()->bestCategory = maxMoveType;
+			if (quiet && i >= 3 && remainingDepth >= 3 && !inCheck && !board.getCheck())
+				reduction = (i >= 6 && remainingDepth >= 6) ? 2 : 1;
 
-		switch (maxMoveType)
-		{
-		case action::BACKWARD:
-			backwardActions.push_back(actions.back());
-			break;
-		case action::FORWARD:
-			forwardActions.push_back(actions.back());
-			break;
-		case action::CHECK:
-			checkActions.push_back(actions.back());
-			break;
-		case action::DOUBLE_CHECK:
-			doubleCheckActions.push_back(actions.back());
-			break;
-		case action::CASTLE:
-			castleActions.push_back(actions.back());
-			break;
-		case action::CAPTURE:
-			captureActions.push_back(actions.back());
-			break;
-		case action::PROMOTION:
-			promotionActions.push_back(actions.back());
-		}
+			score = -negamax(worker, -alpha - 1, -alpha, remainingDepth - 1 - reduction, ply + 1);
 
-		actions.pop_back();
-	}
+			if (score > alpha && reduction > 0)
+				score = -negamax(worker, -alpha - 1, -alpha, remainingDepth - 1, ply + 1);
 
-	//	The actions are organized, now we need to sort each separate container by ascending order of their heuristic values.
-	backwardActions.sort([](action* a1, action* a2)->bool { return a1->heuristic < a2->heuristic; });
-	forwardActions.sort([](action* a1, action* a2)->bool { return a1->heuristic < a2->heuristic; });
-	checkActions.sort([](action* a1, action* a2)->bool { return a1->heuristic < a2->heuristic; });
-	doubleCheckActions.sort([](action* a1, action* a2)->bool { return a1->heuristic < a2->heuristic; });
-	castleActions.sort([](action* a1, action* a2)->bool { return a1->heuristic < a2->heuristic; });
-	captureActions.sort([](action* a1, action* a2)->bool { return a1->heuristic < a2->heuristic; });
-	promotionActions.sort([](action* a1, action* a2)->bool { return a1->heuristic < a2->heuristic; });
+			if (score > alpha && score < beta)
+				score = -negamax(worker, -beta, -alpha, remainingDepth - 1, ply + 1);
+		}
 
-	std::stack<action*> actionStack;
+		///	TAKE THE MOVE BACK.
+		board.unmakeMove(undo);
 
-	//	Move category containers are sorted, now to push them onto the stack in ascending categorical order (backwardActions first -> promotionActions last)
-	while (!backwardActions.empty())
-	{
-		actionStack.push(backwardActions.front());
-		backwardActions.pop_front();
-	}
+		//	Out of time - the score is meaningless, and nothing is stored for this position.
+		if (stopSearch)
+			return 0;
 
-	while (!forwardActions.empty())
-	{
-		actionStack.push(forwardActions.front());
-		forwardActions.pop_front();
-	}
+		/// IF THE GENERATED MOVES THAT LEAD TO LEAF NODE ARE BETTER THAN CURRENT BEST MOVE, UPDATE THE CURRENT BEST MOVE AND ALPHA VALUE.
+		//	The root always takes its first move, so there is a move to play even if every move loses.
+		if (score > alpha || (ply == 0 && i == 0))
+		{
+			if (ply == 0)
+				worker.rootMove = move;
 
-	while (!checkActions.empty())
-	{
-		actionStack.push(checkActions.front());
-		checkActions.pop_front();
-	}
+			if (score > alpha)
+			{
+				alpha = score;
+				bestMove = move;
+			}
+		}
 
-	while (!doubleCheckActions.empty())
-	{
-		actionStack.push(doubleCheckActions.front());
-		doubleCheckActions.pop_front();
-	}
+		///	IF THE LEAF NODE SCORED LARGER THAN THE BETA VALUE, STOP SEARCHING.
+		if (score >= beta)
+		{
+			if (quiet)
+				updateQuietHistory(worker, move, ply, remainingDepth);
 
-	while (!castleActions.empty())
-	{
-		actionStack.push(castleActions.front());
-		castleActions.pop_front();
+			table.store(key, move, beta, remainingDepth, LOWER_BOUND, ply);
+			return beta;		// Beta cut-off
+		}
 	}
 
-	while (!captureActions.empty())
+	//	No legal moves means the side to move has been checkmated, or it's a stalemate (a draw).
+	if (moveCount == 0)
 	{
-		actionStack.push(captureActions.front());
-		captureActions.pop_front();
-	}
+		if (inCheck)
+			return -(MATE - ply);
 
-	while (!promotionActions.empty())
-	{
-		actionStack.push(promotionActions.front());
-		promotionActions.pop_front();
+		return 0;
 	}
 
-	// It's possible for actionStack to be empty, if the last move resulted in the king and the remaining pieces having no valid moves (like a trapped king with blocked pawns).
-	if (actionStack.empty() && node->gameState.getEscapeVector()->empty())
-	{
-		action* drawData = new action(NULL, -1, -1, -1, -1);
-		drawData->bestCategory = action::DRAW;
-		actionStack.push(drawData);
-	}
+	//	If no move beat alpha, all that is known is that the position is worth alpha or less.
+	table.store(key, bestMove, alpha, remainingDepth, (alpha > originalAlpha) ? EXACT_BOUND : UPPER_BOUND, ply);
 
-	return actionStack;
+	return alpha;
 }
 
-// This will attempt various moves on a passed piece to determine if they should be added to the actionList.
-void chessGameTree::buildActions(gameStateNode* node, chessPiece& piece, std::vector<action*>& actionList)
+//	Searches captures and promotions only, returning the alpha-beta value of the position once it has gone quiet.
+int chessGameTree::quiescence(searchWorker& worker, int alpha, int beta, int ply)
 {
-	// Notes on buildActions
-	/*
-	If possible, we will avoid creating a copy of the game-board to see if a move is valid.  As discussed in chessBoardClass.cpp,
-	this is really slow, and will be especially costly given that the AI will be building (hundreds of?) thousands of these actions each turn.
+	chessBoardClass& board = worker.board;
 
-	This can be avoided by obtaining the needed data for node->gameState's (chessBoardClass) accessor methods.  Things like
-	the checkVector, saviorVector, etc.  We'll essentially be needing to perform the various board checks that chessBoardClass
-	performs while seeing if a move is valid, without actually performing the move.
+	if (visitNode(worker))
+		return 0;
 
-	Alternatively, modifying chessBoardClass's move() method to take a boolean flag that causes it to simply return whether
-	or not a move is legal and not actually perform the move could work.  This would perform all of the movement tests
-	to ensure the move is legal, while not having to re-copy the gameState of the node for all of the potential children it will create.
+	bool inCheck = board.getCheck();
+	int standPat = 0;
 
-	There are some optimizations that can be done to save a bit of time:
+	//	Stand pat:  Captures don't have to be played, so the side to move is worth at least what the position is worth
+	//	right now.  That isn't true in check, where every way out has to be looked at.
+	if (!inCheck)
+	{
+		standPat = evaluatePosition(board);
 
-	-	If piece->type != "king" && checkVector.size() > 1, then we can immediately return.
-	-	If piece->type == "king", then the only actions the king can take are moves in escapeVector.
+		if (standPat >= beta)
+			return beta;
+		if (standPat > alpha)
+			alpha = standPat;
+	}
 
-	-	If (checkVector.size() == 1), then the only pieces that can be moved are those that are in
-	saviorVector, and the only squares they can move to are in attackVector and escapeVector (for king only).
+	moveList moves;
+	board.generateMoves(moves, !inCheck);
 
-	-	A special case should be made for a piece that is an element of pinVector:  only moves that are in the direction of the pin
-	should be attempted.  It would be a waste of time to do any others.
-	*-*	Would it?  The multi-test movement logic already checks for this.  Is the work testing illegal moves greater than doing the
-	pin test twice?  Unsure, as it depends on the number of illegal moves, but I'm going to assume it's better to minimize the
-	problem space (we'll test "twice" for pins).
+	//	Terminal node!  The side to move is in check and has no way out of it.
+	if (inCheck && moves.empty())
+		return -(MATE - ply);
 
-	*/
+	//	Most valuable victim first, and of those, least valuable attacker first.
+	for (int i = 0; i < moves.size(); ++i)
+	{
+		chessMove move = moves[i];
+		chessPiece* attacker = board.getSquareContents(move.getOrigC(), move.getOrigR());
 
-	chessBoardClass board;
-	board.init();
+		moves.scores[i] = 10 * getMaterialGain(board, move) - val.getValue(attacker->getType()) / 100;
+	}
 
-	board = node->gameState;
+	//	A capture that can't raise the score to alpha even with this much positional change thrown in isn't worth searching.
+	const int deltaMargin = 200;
 
-	PIECE_TYPE type = piece.getType();
-	std::vector<chessPiece*>* checkVector = board.getCheckVector();
-	std::vector<chessPiece*>* saviorVector = board.getSaviorVector();
-	std::vector<std::pair<std::pair<chessPiece*, chessPiece*>, PIN_DIR>>* pinVector = board.getPinVector();
-	std::vector<std::pair<int, int>>* attackVector = board.getAttackVector();
-	std::vector<std::pair<int, int>>* escapeVector = board.getEscapeVector();
+	for (int i = 0; i < moves.size(); ++i)
+	{
+		chessMove move = moves.pickNext(i);
 
-	bool kingInCheck = board.getCheck();
+		//	The AI always promotes to a queen, except in check, where every way out has to be looked at.
+		if (!inCheck && move.getFlag() == PROMOTION_MOVE && move.getPromotion() != QUEEN)
+			continue;
 
-	// If more than two pieces are checking the king, then only the king can be moved.
-	if (checkVector->size() > 1 && type != KING)
-		return;
+		///	DELTA PRUNING.
+		if (!inCheck && standPat + getMaterialGain(board, move) + deltaMargin <= alpha)
+			continue;
 
-	// If one piece is checking the king, only savior pieces or the king may be moved.
-	if (kingInCheck && type != KING)
-	{
-		bool found = false;
-		for (int i = 0; i < saviorVector->size() && !found; ++i)
-		{
-			chessPiece* savior = (*saviorVector)[i];
-			if (piece == *savior)
-				found = true;
-		}
+		///	SKIP CAPTURES THAT LOSE MATERIAL.
+		//	If the exchange on the square comes out behind, standing pat is at least as good.
+		if (!inCheck && board.staticExchange(move) < 0)
+			continue;
 
-		if (!found)
-			return;
-	}
+		undoInfo undo;
+		board.makeMove(move, undo);
 
-	bool isPinned = false;
-	PIN_DIR pinDirection = PIN_DIR(-1);
+		int score = -quiescence(worker, -beta, -alpha, ply + 1);
 
-	// See if piece is pinned.
-	for (int i = 0; i < pinVector->size(); ++i)
-	{
-		chessPiece* pinnedPiece = (*pinVector)[i].first.first;
-		if (piece == *pinnedPiece)
-		{
-			isPinned = true;
-			pinDirection = (*pinVector)[i].second;
-			break;
-		}
-	}
+		board.unmakeMove(undo);
+
+		if (stopSearch)
+			return 0;
 
-	/// DEBUG DATA STRUCTURES
-	//  Used to store pieces that would be captured if the move occurred, to root out a friendly fire bug.
-	std::stack<std::pair<chessPiece*, action*>> debugStack;
-	chessPiece* debugPtr;
+		if (score >= beta)
+			return beta;
+		if (score > alpha)
+			alpha = score;
+	}
 
-	//	Flag will be used with chessBoardClass move() calls to test for move legality without actually performing move.
-	const bool checkLegality = true;
+	return alpha;
+}
 
-	int origC = piece.getColumn();
-	int origR = piece.getRow();
+//	Counts the position being visited.  The main thread checks the limits on the search, looking at the clock every so
+//	many positions; the first iteration always finishes, so there is a move to play however little time there is.
+bool chessGameTree::visitNode(searchWorker& worker)
+{
+	const std::uint64_t clockCheckInterval = 2048;
 
-	action* newAction = NULL;
+	//	Other threads only ever read the count, so it doesn't need an atomic increment.
+	std::uint64_t nodes = worker.nodeCount.load(std::memory_order_relaxed) + 1;
+	worker.nodeCount.store(nodes, std::memory_order_relaxed);
 
-	//	Test for various cases, adding to actionList where actions are valid.
-	if (kingInCheck)
+	if (worker.id == 0 && completedDepth > 0)
 	{
-		//	If the piece is the king, then try to move to coordinates in escapeVector.
-		//	If the piece is anything else, try to move to coordinates in attackVector.
-		//	Note:  attackVector is typically very small, so don't bother checking for pin here.
+		if (stopRequested || (nodeLimit > 0 && nodes >= nodeLimit)
+			|| (hardLimit > 0 && nodes % clockCheckInterval == 0 && getElapsedTime() >= hardLimit))
+			stopSearch = true;
+	}
 
-		if (type == KING)
-		{
-			for (int i = 0; i < escapeVector->size(); ++i)
-			{
-				if (board.move(origC, origR, (*escapeVector)[i].first, (*escapeVector)[i].second, checkLegality))
-				{
+	return stopSearch;
+}
 
-					int destC = (*escapeVector)[i].first, destR = (*escapeVector)[i].second;
+//	Iterative deepening on a helper thread.  Every other helper starts a ply deeper than the main thread, so that the
+//	threads spread out over different depths instead of all searching the same tree in step.
+void chessGameTree::helperSearch(searchWorker& worker, int depthLimit)
+{
+	for (int depth = 1 + worker.id % 2; depth <= depthLimit && !stopSearch; ++depth)
+		negamax(worker, -MATE, MATE, depth, 0);
+}
 
-					newAction = new action(&piece, origC, origR, destC, destR);
-					newAction->heuristic = evaluateHeuristic(board, newAction);
+//	Returns the material the side to move wins by playing move, before any recapture.
+int chessGameTree::getMaterialGain(chessBoardClass& board, chessMove move)
+{
+	chessPiece* victim = board.getSquareContents(move.getDestC(), move.getDestR());
+	int gain = 0;
 
-					debugPtr = board.getSquareContents(destC, destR);
-					if (debugPtr != NULL)
-						debugStack.push(std::make_pair(debugPtr, newAction));
+	if (move.getFlag() == EN_PASSANT_MOVE)
+		gain = val.pawn;
+	else if (victim != NULL)
+		gain = val.getValue(victim->getType());
 
-					actionList.push_back(newAction);
-				}
-			}
-		}
-		else // The piece in this case is a savior.
-		{
-			for (int i = 0; i < attackVector->size(); ++i)
-			{
-				if (board.move(origC, origR, (*attackVector)[i].first, (*attackVector)[i].second, checkLegality))
-				{
-					int destC = (*attackVector)[i].first, destR = (*attackVector)[i].second;
+	if (move.getFlag() == PROMOTION_MOVE)
+		gain += val.getValue(move.getPromotion()) - val.pawn;
 
-					newAction = new action(&piece, origC, origR, destC, destR);
-					newAction->heuristic = evaluateHeuristic(board, newAction);
+	return gain;
+}
 
-					debugPtr = board.getSquareContents(destC, destR);
-					if (debugPtr != NULL)
-						debugStack.push(std::make_pair(debugPtr, newAction));
+/*
+	=========================================
+	Game Tree Construction - Worker Functions
+	=========================================
+*/
 
-					actionList.push_back(newAction);
-				}
-			}
-		}
-	}
-	else if (type == PAWN)
-	{
-		//	Possible moves for pawn are very small, so don't bother to check for pin here.
-		//	board->move() will do the check for us.
+//	Starts out at the hash move.  The refutations are copied now, since searching the first few moves can replace them.
+movePicker::movePicker(chessGameTree& tree, searchWorker& worker, int ply, int remainingDepth, chessMove hashMove)
+	: tree(tree), worker(worker), board(worker.board), ply(ply), remainingDepth(remainingDepth), stage(HASH_MOVE), hashMove(hashMove),
+	refutationIndex(0), current(0), badCaptures(0), quietsPicked(0), fullyScored(false)
+{
+	refutations[0] = worker.killers[ply][0];
+	refutations[1] = worker.killers[ply][1];
+
+	if (ply > 0 && worker.currentMoves[ply - 1] != chessMove())
+		refutations[2] = worker.counterMoves[worker.currentMoves[ply - 1].getFrom()][worker.currentMoves[ply - 1].getTo()];
+}
+
+//	Works through the stages until one of them has a move to hand out.
+bool movePicker::next(chessMove& move)
+{
+	//	Quiet moves are first ordered by history, with the ones that give check ahead of the rest.  History is kept well
+	//	under checkScore (see updateQuietHistory()).
+	const int checkScore = 1000000;
 
-		// White pieces move "up" the board (movement in positive direction across rows).
-		if (piece.getColor() == WHITE)
+	for (;;)
+	{
+		switch (stage)
 		{
-			//	Test movement cases:  If they pass, then create an action struct for it and push it onto the back of actionList.
+		case HASH_MOVE:
+			stage = GENERATE_CAPTURES;
 
-			//	Case 1:  Forward Movement - 1
-			if (board.move(origC, origR, origC, origR + 1, checkLegality))
+			if (hashMove != chessMove() && board.isLegal(hashMove))
 			{
-				newAction = new action(&piece, origC, origR, origC, origR + 1);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+				move = hashMove;
+				return true;
+			}
 
-				debugPtr = board.getSquareContents(origC, origR + 1);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+			hashMove = chessMove();
+			break;
 
-				actionList.push_back(newAction);
-			}
+		case GENERATE_CAPTURES:
+			board.generateMoves(moves, CAPTURE_MOVES);
 
-			//	Case 2:  Forward Movement - 2
-			if (board.move(origC, origR, origC, origR + 2, checkLegality))
+			for (int i = 0; i < moves.size(); ++i)
 			{
-				newAction = new action(&piece, origC, origR, origC, origR + 2);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
-
-				debugPtr = board.getSquareContents(origC, origR + 2);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+				chessPiece* attacker = board.getSquareContents(moves[i].getOrigC(), moves[i].getOrigR());
 
-				actionList.push_back(newAction);
+				moves.scores[i] = 10 * tree.getMaterialGain(board, moves[i]) - val.getValue(attacker->getType()) / 100;
 			}
 
-			//	Case 3:  Diagonal Attack - Up Left
-			if (board.move(origC, origR, origC - 1, origR + 1, checkLegality))
+			stage = GOOD_CAPTURES;
+			break;
+
+		case GOOD_CAPTURES:
+			while (current < moves.size())
 			{
-				newAction = new action(&piece, origC, origR, origC - 1, origR + 1);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+				chessMove capture = moves.pickNext(current++);
 
-				debugPtr = board.getSquareContents(origC - 1, origR + 1);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+				//	The AI always promotes to a queen (an action has no room for the piece), so the other choices are dropped.
+				if (capture == hashMove || (capture.getFlag() == PROMOTION_MOVE && capture.getPromotion() != QUEEN))
+					continue;
 
-				actionList.push_back(newAction);
+				if (board.staticExchange(capture) < 0)
+				{
+					moves.moves[badCaptures++] = capture;
+					continue;
+				}
+
+				move = capture;
+				return true;
 			}
 
-			//	Case 4:  Diagonal Attack - Up Right
-			if (board.move(origC, origR, origC + 1, origR + 1, checkLegality))
+			stage = REFUTATIONS;
+			break;
+
+		case REFUTATIONS:
+			while (refutationIndex < 3)
 			{
-				newAction = new action(&piece, origC, origR, origC + 1, origR + 1);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+				chessMove& refutation = refutations[refutationIndex++];
+
+				//	Learned in other positions, so it has to be a quiet move that is legal here, and not already handed out.
+				bool usable = refutation != chessMove() && refutation != hashMove
+					&& (refutation.getFlag() == NORMAL_MOVE || refutation.getFlag() == CASTLE_MOVE)
+					&& board.getSquareContents(refutation.getDestC(), refutation.getDestR()) == NULL;
 
-				debugPtr = board.getSquareContents(origC + 1, origR + 1);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+				for (int i = 0; usable && i < refutationIndex - 1; ++i)
+					usable = refutations[i] != refutation;
+
+				if (usable && board.isLegal(refutation))
+				{
+					move = refutation;
+					return true;
+				}
 
-				actionList.push_back(newAction);
+				refutation = chessMove();
 			}
 
-		}	// Black pieces move "down" the board (movement in negative direction across rows).
-		else if (piece.getColor() == BLACK)
-		{
-			// Test movement cases:  If they pass, then create an action struct for it and push it onto the back of actionList.
+			stage = GENERATE_QUIETS;
+			break;
 
-			//	Case 1:  Forward Movement - 1
-			if (board.move(origC, origR, origC, origR - 1, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, origC, origR - 1);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+		case GENERATE_QUIETS:
+		{
+			//	The quiet moves go after the captures that were put aside, over the ones that were handed out.
+			int side = board.getTurn();
 
-				debugPtr = board.getSquareContents(origC, origR - 1);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+			moves.count = badCaptures;
+			current = badCaptures;
+			board.generateMoves(moves, QUIET_MOVES);
 
-				actionList.push_back(newAction);
-			}
+			checkInfo checks;
+			board.getCheckInfo(checks);
 
-			//	Case 2:  Forward Movement - 2
-			if (board.move(origC, origR, origC, origR - 2, checkLegality))
+			for (int i = current; i < moves.size(); ++i)
 			{
-				newAction = new action(&piece, origC, origR, origC, origR - 2);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+				moves.scores[i] = worker.history[side][moves[i].getFrom()][moves[i].getTo()];
 
-				debugPtr = board.getSquareContents(origC, origR - 2);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
-
-				actionList.push_back(newAction);
+				if (board.givesCheck(moves[i], checks))
+					moves.scores[i] += checkScore;
 			}
 
-			//	Case 3:  Diagonal Attack - Down Left
-			if (board.move(origC, origR, origC - 1, origR - 1, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, origC - 1, origR - 1);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+			stage = QUIETS;
+			break;
+		}
 
-				debugPtr = board.getSquareContents(origC - 1, origR - 1);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+		case QUIETS:
+			//	The cheap order has had its chance to find a cut-off.  Where there is enough search left below the node to
+			//	make it worth it, the rest of the quiet moves are ordered by the full heuristic from here on.
+			if (!fullyScored && quietsPicked >= cheapQuietMoves && remainingDepth >= fullScoreDepth)
+				scoreQuietsFully();
+
+			while (current < moves.size())
+			{
+				chessMove quiet = moves.pickNext(current++);
 
-				actionList.push_back(newAction);
+				if (!alreadyPicked(quiet))
+				{
+					++quietsPicked;
+					move = quiet;
+					return true;
+				}
 			}
 
-			//	Case 4:  Diagonal Attack - Down Right
-			if (board.move(origC, origR, origC + 1, origR - 1, checkLegality))
+			current = 0;
+			stage = BAD_CAPTURES;
+			break;
+
+		case BAD_CAPTURES:
+			if (current < badCaptures)
 			{
-				newAction = new action(&piece, origC, origR, origC + 1, origR - 1);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+				move = moves[current++];
+				return true;
+			}
 
-				debugPtr = board.getSquareContents(origC + 1, origR - 1);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+			stage = NO_MOVES_LEFT;
+			break;
 
-				actionList.push_back(newAction);
-			}
+		default:
+			return false;
 		}
 	}
-	else if (type == KNIGHT)
-	{
-		// Knights cannot be moved as pinned pieces, so if the knight is pinned just return.
+}
 
-		if (isPinned)
-			return;
+//	Rescores the quiet moves not yet handed out by their best quality first, and by heuristic value within a quality, where...
+//  backward < forward < check < double check < castle
+//	A quality is worth more than any heuristic value, so one score is enough to sort on.  History is added on top.
+void movePicker::scoreQuietsFully()
+{
+	const int categoryWeight = 1000000;
 
-		//	Test movement cases
+	int side = board.getTurn();
 
-		//	Case 1:  Up 1 - Right 2
-		if (board.move(origC, origR, origC + 2, origR + 1, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC + 2, origR + 1);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
+	for (int i = current; i < moves.size(); ++i)
+	{
+		action::MOVE_TYPE category;
+		int heuristic = tree.evaluateHeuristic(board, moves[i], category);
 
-			debugPtr = board.getSquareContents(origC + 2, origR + 1);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
+		moves.scores[i] = category * categoryWeight + heuristic + worker.history[side][moves[i].getFrom()][moves[i].getTo()];
+	}
 
-			actionList.push_back(newAction);
-		}
+	fullyScored = true;
+}
 
-		//	Case 2:  Up 2 - Right 1
-		if (board.move(origC, origR, origC + 1, origR + 2, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC + 1, origR + 2);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
+bool movePicker::alreadyPicked(chessMove move) const
+{
+	return move == hashMove || move == refutations[0] || move == refutations[1] || move == refutations[2];
+}
 
-			debugPtr = board.getSquareContents(origC + 1, origR + 2);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
+//	Moves the cut-off move to the front of the killers for its ply, makes it the countermove to the move before it,
+//	and adds to its history.  Deeper cut-offs say more, so history goes up by the square of the depth.
+void chessGameTree::updateQuietHistory(searchWorker& worker, chessMove move, int ply, int remainingDepth)
+{
+	//	History is kept well under the gap between two qualities, so it only ever reorders moves within one.
+	const int historyLimit = 250000;
 
-			actionList.push_back(newAction);
-		}
+	if (worker.killers[ply][0] != move)
+	{
+		worker.killers[ply][1] = worker.killers[ply][0];
+		worker.killers[ply][0] = move;
+	}
 
-		//	Case 3:  Up 2 - Left 1
-		if (board.move(origC, origR, origC - 1, origR + 2, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC - 1, origR + 2);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
+	if (ply > 0 && worker.currentMoves[ply - 1] != chessMove())
+		worker.counterMoves[worker.currentMoves[ply - 1].getFrom()][worker.currentMoves[ply - 1].getTo()] = move;
 
-			debugPtr = board.getSquareContents(origC - 1, origR + 2);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
+	int side = worker.board.getTurn();
+	int& entry = worker.history[side][move.getFrom()][move.getTo()];
 
-			actionList.push_back(newAction);
-		}
+	entry += remainingDepth * remainingDepth;
 
-		//	Case 4:  Up 1 - Left 2
-		if (board.move(origC, origR, origC - 2, origR + 1, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC - 2, origR + 1);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
+	//	Halving everything keeps the order of the table, while letting newer cut-offs count for more than old ones.
+	if (entry > historyLimit)
+		for (int i = 0; i < 64; ++i)
+			for (int j = 0; j < 64; ++j)
+				worker.history[side][i][j] /= 2;
+}
 
-			debugPtr = board.getSquareContents(origC - 2, origR + 1);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
+//	Evaluates a leaf node of the game tree, returning an integer value that represents how favorable of a game state the moves that lead to the leaf lead to.
+int chessGameTree::evaluatePosition(chessBoardClass& board)
+{
+	//	The board keeps running totals of material and piece-position values for the middlegame and the endgame as moves
+	//	are made.  The two are blended by how far into the game the position is (see chessEvaluationTables.h), so the
+	//	king is steered toward the center a little more with every piece that comes off the board.
+	int phase = std::min(board.getGamePhase(), MAX_GAME_PHASE);
 
-			actionList.push_back(newAction);
-		}
+	int score = (board.getPhaseScore(MIDGAME) * phase + board.getPhaseScore(ENDGAME) * (MAX_GAME_PHASE - phase)) / MAX_GAME_PHASE;
 
-		//	Case 5:  Down 1 - Left 2
-		if (board.move(origC, origR, origC - 2, origR - 1, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC - 2, origR - 1);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
+	//	The score is from white's point of view, and the search wants it from the side to move's.
+	return (board.getTurn() == WHITE) ? score : -score;
+}
 
-			debugPtr = board.getSquareContents(origC - 2, origR - 1);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
+// Returns an int value that represents how promising a move is based on the heuristic function from the notes in chessAI.h
+int chessGameTree::evaluateHeuristic(chessBoardClass& board, chessMove move, action::MOVE_TYPE& category)
+{
+	//double captureVal, attackVal, checkVal, forwardMovementVal, centerControlVal, kingDefenseVal, pawnPromotion;
+	int captureVal, checkVal, kingDefenseVal, forwardMovementVal, pawnPromotion, positionVal;
 
-			actionList.push_back(newAction);
-		}
+	int origC = move.getOrigC(), origR = move.getOrigR(), destC = move.getDestC(), destR = move.getDestR();
+	chessPiece* piece = board.getSquareContents(origC, origR);
 
-		//	Case 6:  Down 2 - Left 1
-		if (board.move(origC, origR, origC - 1, origR - 2, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC - 1, origR - 2);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
+	category = action::BACKWARD;
+	captureVal = 0;
 
-			debugPtr = board.getSquareContents(origC - 1, origR - 2);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
+	//	Determine captureVal.  The static exchange is what the capture wins (or loses) once the recaptures on the square have been
+	//	played out, which says far more than the value of the captured piece alone.
+	if (board.getSquareContents(destC, destR) != NULL || move.getFlag() == EN_PASSANT_MOVE)
+	{
+		captureVal = board.staticExchange(move);
 
-			actionList.push_back(newAction);
-		}
+		//	A capture that loses material is no better than a quiet move, and goes behind the quiet moves of its quality.
+		if (captureVal >= 0)
+			category = std::max(category, action::CAPTURE);
+	}
 
-		//	Case 7:  Down 2 - Right 1
-		if (board.move(origC, origR, origC + 1, origR - 2, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC + 1, origR - 2);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
+	//	attackVal has been phased out for the moment.
+	/*
+	//	Determine attackVal
 
-			debugPtr = board.getSquareContents(origC + 1, origR - 2);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
+	//	Get number of pieces being attacked from original position.
+	std::vector<chessPiece*> origTargets = getTargets(board, moveData);
+	//	Get number of pieces being attacked from new position.
 
-			actionList.push_back(newAction);
-		}
 
-		//	Case 8:  Down 1 - Right 2
-		if (board.move(origC, origR, origC + 2, origR - 1, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC + 2, origR - 1);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
+	action* postMoveData = new action(moveData->piece, moveData->destC, moveData->destR, -1, -1);
+	std::vector<chessPiece*> newTargets = getTargets(board, postMoveData);
+	delete postMoveData;
 
-			debugPtr = board.getSquareContents(origC + 2, origR - 1);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
+	if (origTargets.size() != 0)
+	{
+	attackVal = int(newTargets.size() - origTargets.size()) / 2.0;
 
-			actionList.push_back(newAction);
-		}
+	if (AI_DEBUG)
+	{
+	std::cout << "\n\n==========DEBUG==========\norigTargets.size() != 0\n";
+	std::cout << "newTargets.size() == " << newTargets.size() << std::endl;
+	std::cout << "origTargets.size() == " << origTargets.size() << std::endl;
+	std::cout << "attackVal = " << attackVal << "\n\n" << std::endl;
+	}
 
 	}
-	else if (type == BISHOP)
+	else
 	{
-		//	Bishop movement is strictly diagonal, so if pin direction comes from a non-diagonal direction we can just return.
-		if (pinDirection == UP || pinDirection == DOWN || pinDirection == LEFT || pinDirection == RIGHT)
-			return;
-
-		//	Case 1:  Up - Right Movement
-		for (int destC = origC + 1, destR = origR + 1; destC <= 7 && destR <= 7; ++destC, ++destR)
-		{
-			//	Movement range for bishop is potentially large, so potential pin direction must be checked.
-			if (isPinned && pinDirection != UP_RIGHT)
-				break;
-
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
-
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
-
-				actionList.push_back(newAction);
-			}
-			else // The moment a move becomes illegal, we can stop scanning.
-				break;
-		}
-
-		//	Case 2:  Up - Left Movement
-		for (int destC = origC - 1, destR = origR + 1; destC >= 0 && destR <= 7; --destC, ++destR)
-		{
-			if (isPinned && pinDirection != UP_LEFT)
-				break;
-
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
-
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
-
-				actionList.push_back(newAction);
-			}
-			else
-				break;
-		}
-
-		//	Case 3:  Down - Left Movement
-		for (int destC = origC - 1, destR = origR - 1; destC >= 0 && destR >= 0; --destC, --destR)
-		{
-			if (isPinned && pinDirection != DOWN_LEFT)
-				break;
-
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
-
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
-
-				actionList.push_back(newAction);
-			}
-			else
-				break;
-		}
-
-		//	Case 4:  Down - Right Movement
-		for (int destC = origC + 1, destR = origR - 1; destC <= 7 && destR >= 0; ++destC, --destR)
-		{
-			if (isPinned && pinDirection != DOWN_RIGHT)
-				break;
-
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+	attackVal = newTargets.size();
 
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+	if (AI_DEBUG)
+	{
+	std::cout << "\n\n==========DEBUG==========\norigTargets.size() == 0\n";
+	std::cout << "newTargets.size() == " << newTargets.size() << std::endl;
+	std::cout << "attackVal = " << attackVal << "\n\n" << std::endl;
+	}
 
-				actionList.push_back(newAction);
-			}
-			else
-				break;
-		}
 	}
-	else if (type == ROOK)
+	if (AI_DEBUG && attackVal > 10)
 	{
-		//	Rook movement is strictly non-diagonal, so if pin direction comes from a diagonal direction we can just return.
-		if (pinDirection == UP_RIGHT || pinDirection == UP_LEFT || pinDirection == DOWN_LEFT || pinDirection == DOWN_RIGHT)
-			return;
+	std::cout << "\n\n========DEBUG=========\nattackVal has large value!!! (" << attackVal << ")\n\n" << std::endl;
+	std::cin.get();
+	}
+	*/
 
-		//	Case 1:  Right Movement
-		for (int destC = origC + 1, destR = origR; destC <= 7; ++destC)
-		{
-			//	Movement range for rook is potentially large, so potential pin direction must be checked.
-			if (isPinned && pinDirection != RIGHT)
-				break;
+	//	Determine checkValue
 
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+	//	Count the pieces that check the enemy king after the move, so the checkValue can be larger when there are multiple checking pieces.
+	int checkingPieces = countCheckers(board, move);
 
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+	if (checkingPieces == 1)
+	{
+		category = std::max(category, action::CHECK);
+		checkVal = 2;
+	}
+	else if (checkingPieces > 1)
+	{
+		category = std::max(category, action::DOUBLE_CHECK);
+		checkVal = 5;
+	}
+	else
+		checkVal = 0;
 
-				actionList.push_back(newAction);
-			}
-			else // The moment a move becomes illegal, we can stop scanning.
-				break;
-		}
+	if (captureVal >= 0 && checkVal > 0)
+		return 100 * captureVal + checkVal;
 
-		//	Case 2:  Upward Movement
-		for (int destC = origC, destR = origR + 1; destR <= 7; ++destR)
-		{
-			if (isPinned && pinDirection != UP)
-				break;
+	//	Determine forwardMovementVal
+	if (piece->getColor() == WHITE)
+	{
+		//	White moves up the board, so if destR > origR, then from white's perspective it has moved forward.
+		forwardMovementVal = double(destR - origR);
+	}
+	else if (piece->getColor() == BLACK)
+	{
+		//	Black moves down the board, so if origR > destR, then from black's perspective it has moved forward.
+		forwardMovementVal = double(origR - destR);
+	}
 
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+	if (forwardMovementVal >= 0.0)
+		category = std::max(category, action::FORWARD);
+	else
+		category = std::max(category, action::BACKWARD);
 
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+	//	This has been phased out in favor of piece-position value tables, as implemented below.
+	/*
+	//	Determine centerControlVal
+	double origCenterControl, destCenterControl;
+	//	The greater the distance from the center, the greater the penalty - except for the king.
+	//	Distance = abs(position - 3.5)
 
-				actionList.push_back(newAction);
-			}
-			else
-				break;
-		}
+	origCenterControl = abs(moveData->origC - 3.5) + abs(moveData->origR - 3.5);
+	destCenterControl = abs(moveData->destC - 3.5) + abs(moveData->destR - 3.5);
 
-		//	Case 3:  Left Movement
-		for (int destC = origC - 1, destR = origR; destC >= 0; --destC)
-		{
-			if (isPinned && pinDirection != LEFT)
-				break;
+	//	If the destination square is further away from the orig square, then a negative value is appropriate.
+	centerControlVal = (origCenterControl - destCenterControl) / 2;
 
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+	//	It can be important for the king to move to the center at times (like near the end game), so lessen the penalty.
+	if (moveData->piece->getType() == KING)
+	centerControlVal = -centerControlVal / 4;
 
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+	*/
 
-				actionList.push_back(newAction);
-			}
-			else
-				break;
-		}
+	//	Determine kingDefenseVal
+	//	Defenders are the friendly pieces in eight-direction eye-sight of the king.
+	int kingSquare = lowestSquare(board.getPieces(piece->getColor(), KING));
 
-		//	Case 4:  Downward Movement
-		for (int destC = origC, destR = origR - 1; destR >= 0; --destR)
-		{
-			if (isPinned && pinDirection != DOWN)
-				break;
+	double origDefenseVal = popCount(queenAttacks(kingSquare, board.getOccupied()) & board.getPieces(piece->getColor())) / 8.0;
 
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+	double destDefenseVal = countDefenders(board, move) / 8.0;
 
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+	double castleMultiplier = 1.0;
 
-				actionList.push_back(newAction);
-			}
-			else
-				break;
-		}
-	}
-	else if (type == QUEEN)
+	if (move.getFlag() == CASTLE_MOVE)
 	{
-		//	Case 1:  Right Movement
-		for (int destC = origC + 1, destR = origR; destC <= 7; ++destC)
-		{
-			//	Movement range for queen is potentially large, so potential pin direction must be checked.
-			if (isPinned && pinDirection != RIGHT)
-				break;
-
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+		category = std::max(category, action::CASTLE);
+		castleMultiplier = 10.0;
+	}
 
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
 
-				actionList.push_back(newAction);
-			}
-			else // The moment a move becomes illegal, we can stop scanning.
-				break;
-		}
+	kingDefenseVal = 100 * castleMultiplier * (destDefenseVal + origDefenseVal) / 2;
 
-		//	Case 2:  Up - Right Movement
-		for (int destC = origC + 1, destR = origR + 1; destC <= 7 && destR <= 7; ++destC, ++destR)
-		{
-			if (isPinned && pinDirection != UP_RIGHT)
-				break;
+	//	Determine pawnPromotion.  The AI always promotes to a queen, so the gain is a queen for a pawn.
+	pawnPromotion = (move.getFlag() == PROMOTION_MOVE) ? val.queen - val.pawn : 0;
 
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+	if (int(pawnPromotion) > 0)
+		category = std::max(category, action::PROMOTION);
 
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
 
-				actionList.push_back(newAction);
-			}
-			else
-				break;
-		}
+	//	Determine positional value.
+	bool midgame = false;
+	bool endgame = false;
 
-		//	Case 3:  Upward Movement
-		for (int destC = origC, destR = origR + 1; destR <= 7; ++destR)
-		{
-			if (isPinned && pinDirection != UP)
-				break;
+	bitboard minorPieces = board.getPieces(KNIGHT) | board.getPieces(BISHOP) | board.getPieces(ROOK);
 
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+	if (board.getPieces(QUEEN) != 0)
+	{
+		if (minorPieces == 0)
+			endgame = true;
+	}
+	else
+	{
+		if (popCount(minorPieces & board.getPieces(WHITE)) <= 2 && popCount(minorPieces & board.getPieces(BLACK)) <= 2)
+			endgame = true;
+	}
 
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+	PIECE_COLOR color = piece->getColor();
+	PIECE_TYPE type = piece->getType();
 
-				actionList.push_back(newAction);
-			}
-			else
-				break;
-		}
+	if (!endgame) midgame = true;
 
-		//	Case 4:  Up - Left Movement
-		for (int destC = origC - 1, destR = origR + 1; destC >= 0 && destR <= 7; --destC, ++destR)
+	if (color == WHITE)
+		switch (type)
 		{
-			if (isPinned && pinDirection != UP_LEFT)
-				break;
-
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
-
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
-
-				actionList.push_back(newAction);
-			}
-			else
-				break;
+		case PAWN:
+			positionVal = pawnPosValue[7 - destR][destC] - pawnPosValue[7 - origR][origC];
+			break;
+		case KNIGHT:
+			positionVal = knightPosValue[7 - destR][destC] - knightPosValue[7 - origR][origC];
+			break;
+		case BISHOP:
+			positionVal = bishopPosValue[7 - destR][destC] - bishopPosValue[7 - origR][origC];
+			break;
+		case ROOK:
+			positionVal = rookPosValue[7 - destR][destC] - rookPosValue[7 - origR][origC];
+			break;
+		case QUEEN:
+			positionVal = queenPosValue[7 - destR][destC] - queenPosValue[7 - origR][origC];
+			break;
+		case KING:
+			if (midgame) positionVal = kingPosValue_MID[7 - destR][destC] - kingPosValue_MID[7 - origR][origC];
+			else if (endgame) positionVal = kingPosValue_END[7 - destR][destC] - kingPosValue_END[7 - origR][origC];
 		}
-
-		//	Case 5:  Left Movement
-		for (int destC = origC - 1, destR = origR; destC >= 0; --destC)
+	else if (color == BLACK)
+		switch (type)
 		{
-			if (isPinned && pinDirection != LEFT)
-				break;
-
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
-
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
-
-				actionList.push_back(newAction);
-			}
-			else
-				break;
+		case PAWN:
+			positionVal = pawnPosValue[destR][destC] - pawnPosValue[origR][origC];
+			break;
+		case KNIGHT:
+			positionVal = knightPosValue[origR][origC] - knightPosValue[origR][origC];
+			break;
+		case BISHOP:
+			positionVal = bishopPosValue[origR][origC] - bishopPosValue[origR][origC];
+			break;
+		case ROOK:
+			positionVal = rookPosValue[origR][origC] - rookPosValue[origR][origC];
+			break;
+		case QUEEN:
+			positionVal = queenPosValue[origR][origC] - queenPosValue[origR][origC];
+			break;
+		case KING:
+			if (midgame) positionVal = kingPosValue_MID[origR][origC] - kingPosValue_MID[origR][origC];
+			else if (endgame) positionVal = kingPosValue_END[origR][origC] - kingPosValue_END[origR][origC];
 		}
 
-		//	Case 6:  Down - Left Movement
-		for (int destC = origC - 1, destR = origR - 1; destC >= 0 && destR >= 0; --destC, --destR)
-		{
-			if (isPinned && pinDirection != DOWN_LEFT)
-				break;
+	//	Return heuristic value
+	int total = 100 * captureVal + 100 * forwardMovementVal + kingDefenseVal + pawnPromotion + 100 * positionVal;
+	return total;
 
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+}
 
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+/*
+	====================================
+	evaluateHeuristic - Helper Functions
+	====================================
+*/
 
-				actionList.push_back(newAction);
-			}
-			else
-				break;
-		}
+//	Returns a vector containing all of the pieces that moveData->piece is attacking from (moveData->origC, moveData->origR).
+std::vector<chessPiece*> chessGameTree::getTargets(chessBoardClass& board, action* moveData)
+{
+	PIECE_COLOR color = moveData->piece->getColor();
+	PIECE_TYPE type = moveData->piece->getType();
+	std::vector<chessPiece*> targets;
 
-		//	Case 7:  Downward Movement
-		for (int destC = origC, destR = origR - 1; destR >= 0; --destR)
+	if (type == PAWN)
+	{
+		if (color == WHITE)
 		{
-			if (isPinned && pinDirection != DOWN)
-				break;
-
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+			chessPiece* target1 = board.getSquareContents(moveData->origC - 1, moveData->origR + 1);
+			chessPiece* target2 = board.getSquareContents(moveData->origC + 1, moveData->origR + 1);
 
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+			if (target2 != NULL && color != target2->getColor())
+				targets.push_back(target1);
 
-				actionList.push_back(newAction);
-			}
-			else
-				break;
+			if (target2 != NULL && color != target2->getColor())
+				targets.push_back(target2);
 		}
-
-		//	Case 8:  Down - Right Movement
-		for (int destC = origC + 1, destR = origR - 1; destC <= 7 && destR >= 0; ++destC, --destR)
+		else if (color == BLACK)
 		{
-			if (isPinned && pinDirection != DOWN_RIGHT)
-				break;
-
-			if (board.move(origC, origR, destC, destR, checkLegality))
-			{
-				newAction = new action(&piece, origC, origR, destC, destR);
-				newAction->heuristic = evaluateHeuristic(board, newAction);
+			chessPiece* target1 = board.getSquareContents(moveData->origC - 1, moveData->origR - 1);
+			chessPiece* target2 = board.getSquareContents(moveData->origC + 1, moveData->origR - 1);
 
-				debugPtr = board.getSquareContents(destC, destR);
-				if (debugPtr != NULL)
-					debugStack.push(std::make_pair(debugPtr, newAction));
+			if (target1 != NULL && color != target1->getColor())
+				targets.push_back(target1);
 
-				actionList.push_back(newAction);
-			}
-			else
-				break;
+			if (target2 != NULL && color != target2->getColor())
+				targets.push_back(target2);
 		}
 	}
-	else // (type == "king")
+	else if (type == KNIGHT)
 	{
-		//	King cannot be pinned, so don't bother checking for pin case.
+		std::vector<chessPiece*> potentialTargets;
 
-		//	Special Cases:  Castling
-
-		//	Castle Queen-side
-		if (board.move(origC, origR, origC - 2, origR, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC - 2, origR);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
-
-			debugPtr = board.getSquareContents(origC - 2, origR);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
-
-			actionList.push_back(newAction);
-		}
-
-		//	Castle King-side
-		if (board.move(origC, origR, origC + 2, origR, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC + 2, origR);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
-
-			debugPtr = board.getSquareContents(origC + 2, origR);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
-
-			actionList.push_back(newAction);
-		}
-
-		//	In these cases, the king is not in check, so all eight movements are potentially safe.
-
-		//	Case 1:  Right Movement
-		if (board.move(origC, origR, origC + 1, origR, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC + 1, origR);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
-
-			debugPtr = board.getSquareContents(origC + 1, origR);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
-
-			actionList.push_back(newAction);
-		}
-
-		//	Case 2:  Up - Right Movement
-		if (board.move(origC, origR, origC + 1, origR + 1, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC + 1, origR + 1);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
-
-			debugPtr = board.getSquareContents(origC + 1, origR + 1);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
-
-			actionList.push_back(newAction);
-		}
-
-		//	Case 3:  Upward Movement
-		if (board.move(origC, origR, origC, origR + 1, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC, origR + 1);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
-
-			debugPtr = board.getSquareContents(origC, origR + 1);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
-
-			actionList.push_back(newAction);
-		}
-
-		//	Case 4:  Up - Left Movement
-		if (board.move(origC, origR, origC - 1, origR + 1, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC - 1, origR + 1);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
-
-			debugPtr = board.getSquareContents(origC - 1, origR + 1);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
-
-			actionList.push_back(newAction);
-		}
-
-		//	Case 5:  Left Movement
-		if (board.move(origC, origR, origC - 1, origR, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC - 1, origR);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
-
-			debugPtr = board.getSquareContents(origC - 1, origR);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
-
-			actionList.push_back(newAction);
-		}
-
-		//	Case 6:  Down - Left Movement
-		if (board.move(origC, origR, origC - 1, origR - 1, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC - 1, origR - 1);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
-
-			debugPtr = board.getSquareContents(origC - 1, origR - 1);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
-
-			actionList.push_back(newAction);
-		}
-
-		//	Case 7:  Downward Movement
-		if (board.move(origC, origR, origC, origR - 1, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC, origR - 1);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
-
-			debugPtr = board.getSquareContents(origC, origR - 1);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
-
-			actionList.push_back(newAction);
-		}
-
-		//	Case 8:  Down - Right Movement
-		if (board.move(origC, origR, origC + 1, origR - 1, checkLegality))
-		{
-			newAction = new action(&piece, origC, origR, origC + 1, origR - 1);
-			newAction->heuristic = evaluateHeuristic(board, newAction);
-
-			debugPtr = board.getSquareContents(origC + 1, origR - 1);
-			if (debugPtr != NULL)
-				debugStack.push(std::make_pair(debugPtr, newAction));
-
-			actionList.push_back(newAction);
-		}
-	}
-
-	while (!debugStack.empty())
-	{
-		debugPtr = debugStack.top().first;
-		action* aPtr = debugStack.top().second;
-
-		if (debugPtr->getColor() != piece.getColor())
-		{
-			debugStack.pop();
-			continue;
-		}
-
-		std::cout << "DEBUG:: FRIENDLY FIRE ACTION GENERATED!!!" << std::endl;
-		std::cout << "Piece: ";
-
-		switch (piece.getColor())
-		{
-		case WHITE:
-			std::cout << "WHITE ";
-			break;
-		case BLACK:
-			std::cout << "BLACK ";
-		}
-
-		switch (piece.getType())
-		{
-		case PAWN:
-			std::cout << "PAWN";
-			break;
-		case KNIGHT:
-			std::cout << "KNIGHT";
-			break;
-		case BISHOP:
-			std::cout << "BISHOP";
-			break;
-		case ROOK:
-			std::cout << "ROOK";
-			break;
-		case QUEEN:
-			std::cout << "QUEEN";
-			break;
-		case KING:
-			std::cout << "KING";
-			break;
-		}
-
-		std::cout << std::endl << "Target: ";
-
-		chessPiece* target = board.getSquareContents(aPtr->destC, aPtr->destR);
-
-		switch (target->getColor())
-		{
-		case WHITE:
-			std::cout << "WHITE ";
-			break;
-		case BLACK:
-			std::cout << "BLACK ";
-		}
-
-		switch (target->getType())
-		{
-		case PAWN:
-			std::cout << "PAWN";
-			break;
-		case KNIGHT:
-			std::cout << "KNIGHT";
-			break;
-		case BISHOP:
-			std::cout << "BISHOP";
-			break;
-		case ROOK:
-			std::cout << "ROOK";
-			break;
-		case QUEEN:
-			std::cout << "QUEEN";
-			break;
-		case KING:
-			std::cout << "KING";
-			break;
-		}
-
-		std::cout << std::endl;
-		std::cout << "(" << aPtr->origC << ", " << aPtr->origR << ") -> (" << aPtr->destC << ", " << aPtr->destR << ")." << std::endl;
-
-		if (board.move(aPtr->origC, aPtr->origR, aPtr->destC, aPtr->destR, true))
-			std::cout << "Re-evaluation has returned true!!!" << std::endl;
-
-		std::cout << std::endl;
-	}
-
-	//	There's been a problem where pieces are allowed to capture the king.
-	//	Solution:  Discard moves where the destination square is occupied by a king.
-	//	This is really not the core problem, as the king shouldn't even be able to move to a square that is under attack.
-	//	This will be addressed above in kingInCheck.
-
-	return;
-}
-
-//	Evaluates a leaf node of the game tree, returning an integer value that represents how favorable of a game state the moves that lead to the leaf lead to.
-int chessGameTree::evaluatePosition(gameStateNode* node)
-{
-	//	Goal state.
-	if (node->gameState.getCheckmate())
-		return INT_MAX;
-
-	// Evaluate difference in material in potential game state.
-	chessBoardClass& potentialGame = node->gameState;
-
-	int potentialPawnDiff = (potentialGame.getWhitePawns()->size() - potentialGame.getBlackPawns()->size());
-	int potentialKnightDiff = (potentialGame.getWhiteKnights()->size() - potentialGame.getBlackKnights()->size());
-	int potentialBishopDiff = (potentialGame.getWhiteBishops()->size() - potentialGame.getBlackBishops()->size());
-	int potentialRookDiff = (potentialGame.getWhiteRooks()->size() - potentialGame.getBlackRooks()->size());
-	int potentialQueenDiff = (potentialGame.getWhiteQueens()->size() - potentialGame.getBlackQueens()->size());
-
-	int potentialDiff = val.queen * (potentialQueenDiff)+val.rook * (potentialRookDiff)+val.bishop * (potentialBishopDiff)
-		+val.knight * (potentialKnightDiff)+val.pawn * (potentialPawnDiff);
-
-
-	int netMaterialChange = potentialDiff;
-
-	/*
-		We'll differentiate between early/midgame and endgame by the following:
-
-		Endgame:	The following remaining-piece scenarios mean the game is in its endgame state.
-
-		1)	One queen on either/both sides and all minor pieces gone (knights, bishops, and rooks).
-		2)	No queens and only two minor pieces or less on either side (knights, bishops, and rooks).
-
-		The king uses a difference position value array for midgame and endgame, to encourage the king to push up to
-		support pawn promotion.
-	*/
-
-	bool midgame = false;
-	bool endgame = false;
-
-	if (potentialGame.getWhiteQueens()->size() >= 1 || potentialGame.getBlackQueens()->size() >= 1)
-	{
-		if (potentialGame.getWhiteKnights()->empty() && potentialGame.getWhiteBishops()->empty() && potentialGame.getWhiteRooks()->empty())
-		{
-			if (potentialGame.getBlackKnights()->empty() && potentialGame.getBlackBishops()->empty() && potentialGame.getBlackRooks()->empty())
-				endgame = true;
-		}
-	}
-	else if (potentialGame.getWhiteQueens()->empty() && potentialGame.getBlackQueens()->empty())
-	{
-		if ((potentialGame.getWhiteKnights()->size() + potentialGame.getWhiteBishops()->size() + potentialGame.getWhiteRooks()->size()) <= 2)
-			if ((potentialGame.getBlackKnights()->size() + potentialGame.getBlackBishops()->size() + potentialGame.getBlackRooks()->size()) <= 2)
-				endgame = true;
-	}
-
-	if (!endgame) midgame = true;
-
-	//	Will hold white positional values.
-	int whitePosValue = 0;
-
-	//	Will assess pawn positional value, for each pawn.
-	for (auto itr = potentialGame.getWhitePawns()->begin(); itr != potentialGame.getWhitePawns()->end(); ++itr)
-	{
-		int col = (*itr).getColumn();
-		int row = (*itr).getRow();
-
-		//	I designed the chessBoard in a way that its indexed by [col][row], but I don't feel like transpoing all of the piecePosValue arrays.
-		//	Because of this, the arrays will need to be indexed by row first, then column.
-		whitePosValue += pawnPosValue[7 - row][col];
-	}
-
-	//	Will assess knight positional value, for each knight.
-	for (auto itr = potentialGame.getWhiteKnights()->begin(); itr != potentialGame.getWhiteKnights()->end(); ++itr)
-	{
-		int col = (*itr).getColumn();
-		int row = (*itr).getRow();
-
-		whitePosValue += knightPosValue[7 - row][col];
-	}
-
-	//	Will assess bishop positional value, for each bishop.
-	for (auto itr = potentialGame.getWhiteBishops()->begin(); itr != potentialGame.getWhiteBishops()->end(); ++itr)
-	{
-		int col = (*itr).getColumn();
-		int row = (*itr).getRow();
-
-		whitePosValue += bishopPosValue[7 - row][col];
-	}
-
-	//	Will assess rooks positional value, for each rooks.
-	for (auto itr = potentialGame.getWhiteRooks()->begin(); itr != potentialGame.getWhiteRooks()->end(); ++itr)
-	{
-		int col = (*itr).getColumn();
-		int row = (*itr).getRow();
-
-		whitePosValue += rookPosValue[7 - row][col];
-	}
-
-	//	Will assess queens positional value, for each queens.
-	for (auto itr = potentialGame.getWhiteQueens()->begin(); itr != potentialGame.getWhiteQueens()->end(); ++itr)
-	{
-		int col = (*itr).getColumn();
-		int row = (*itr).getRow();
-
-		whitePosValue += queenPosValue[7 - row][col];
-	}
-
-	//	Will assess king's positional value, for king.
-	if (midgame)
-	{
-		whitePosValue += kingPosValue_MID[7 - potentialGame.getWhiteKing()->front().getRow()][potentialGame.getWhiteKing()->front().getColumn()];
-	}
-	else if (endgame)
-	{
-		whitePosValue += kingPosValue_END[7 - potentialGame.getWhiteKing()->front().getRow()][potentialGame.getWhiteKing()->front().getColumn()];
-	}
-
-	int blackPosValue = 0;
-
-	//	Rinse and repeat for black vectors.
-	for (auto itr = potentialGame.getBlackPawns()->begin(); itr != potentialGame.getBlackPawns()->end(); ++itr)
-	{
-		int col = (*itr).getColumn();
-		int row = (*itr).getRow();
-
-		blackPosValue += pawnPosValue[row][col];
-	}
-
-	for (auto itr = potentialGame.getBlackKnights()->begin(); itr != potentialGame.getBlackKnights()->end(); ++itr)
-	{
-		int col = itr->getColumn();
-		int row = itr->getRow();
-
-		blackPosValue += knightPosValue[row][col];
-	}
-
-	for (auto itr = potentialGame.getBlackBishops()->begin(); itr != potentialGame.getBlackBishops()->end(); ++itr)
-	{
-		int col = itr->getColumn();
-		int row = itr->getRow();
-
-		blackPosValue += bishopPosValue[row][col];
-	}
-
-	for (auto itr = potentialGame.getBlackRooks()->begin(); itr != potentialGame.getBlackRooks()->end(); ++itr)
-	{
-		int col = itr->getColumn();
-		int row = itr->getRow();
-
-		blackPosValue += rookPosValue[row][col];
-	}
-
-	for (auto itr = potentialGame.getBlackQueens()->begin(); itr != potentialGame.getBlackQueens()->end(); ++itr)
-	{
-		int col = itr->getColumn();
-		int row = itr->getRow();
-
-		blackPosValue += queenPosValue[row][col];
-	}
-
-	if (midgame)
-	{
-		blackPosValue += kingPosValue_MID[potentialGame.getBlackKing()->front().getRow()][potentialGame.getBlackKing()->front().getColumn()];
-	}
-	else if (endgame)
-	{
-		blackPosValue += kingPosValue_END[potentialGame.getBlackKing()->front().getRow()][potentialGame.getBlackKing()->front().getColumn()];
-	}
-
-	int color;
-
-	if (potentialGame.getTurn() == WHITE)
-		color = 1;
-	else
-		color = -1;
-
-	int netPosValue = whitePosValue - blackPosValue;
-
-
-	return color * (netMaterialChange + netPosValue);
-}
-
-// Returns an int value that represents how promising a move is based on the heuristic function from the notes in chessAI.h
-int chessGameTree::evaluateHeuristic(chessBoardClass& board, action* moveData)
-{
-	//double captureVal, attackVal, checkVal, forwardMovementVal, centerControlVal, kingDefenseVal, pawnPromotion;
-	int captureVal, checkVal, kingDefenseVal, forwardMovementVal, pawnPromotion, positionVal;
-
-	captureVal = 0;
-
-	//	Determine captureVal
-	if (board.getSquareContents(moveData->destC, moveData->destR) != NULL)
-	{
-		chessPiece* capture = board.getSquareContents(moveData->destC, moveData->destR);
-		PIECE_TYPE type = capture->getType();
-
-		moveData->moveTypeList.push_back(action::CAPTURE);
-
-		//	Threat of pawn incrases as it approaches promotion.
-		if (type == PAWN)
-		{
-			if (capture->getColor() == WHITE)
-			{
-				if (capture->getRow() == 5)
-					captureVal = 4 * val.pawn;
-				else if (capture->getRow() == 6)
-					captureVal = 6 * val.pawn;
-			}
-			else if (capture->getColor() == BLACK)
-			{
-				if (capture->getRow() == 2)
-					captureVal = 4 * val.pawn;
-				else if (capture->getRow() == 1)
-					captureVal = 6 * val.pawn;
-			}
-		}
-		else
-		{
-			if (type == KNIGHT)
-				captureVal = val.knight;
-			else if (type == BISHOP)
-				captureVal = val.bishop;
-			else if (type == ROOK)
-				captureVal = val.rook;
-			else if (type == QUEEN)
-				captureVal = val.queen;
-		}
-
-		//	We want to avoid mindlessly capturing pieces (we don't want our queen to capture pawns, only to get captured herself), so
-		//	we'll augment captureVal by subtracting from it a weighted value of the piece that is being moved.
-		int pieceVal;
-
-		switch (moveData->piece->getType())
-		{
-		case PAWN:
-			pieceVal = val.pawn;
-			break;
-		case KNIGHT:
-			pieceVal = val.knight;
-			break;
-		case BISHOP:
-			pieceVal = val.bishop;
-			break;
-		case ROOK:
-			pieceVal = val.rook;
-			break;
-		case QUEEN:
-			pieceVal = val.queen;
-			break;
-		case KING:
-			pieceVal = val.king / 75;	//	King value is huge, so we'll scale it down a bit so as to not discourage the offensive use of the king too strongly.
-		}
-
-		captureVal -= pieceVal;
-	}
-
-	//	attackVal has been phased out for the moment.
-	/*
-	//	Determine attackVal
-
-	//	Get number of pieces being attacked from original position.
-	std::vector<chessPiece*> origTargets = getTargets(board, moveData);
-	//	Get number of pieces being attacked from new position.
-
-
-	action* postMoveData = new action(moveData->piece, moveData->destC, moveData->destR, -1, -1);
-	std::vector<chessPiece*> newTargets = getTargets(board, postMoveData);
-	delete postMoveData;
-
-	if (origTargets.size() != 0)
-	{
-	attackVal = int(newTargets.size() - origTargets.size()) / 2.0;
-
-	if (AI_DEBUG)
-	{
-	std::cout << "\n\n==========DEBUG==========\norigTargets.size() != 0\n";
-	std::cout << "newTargets.size() == " << newTargets.size() << std::endl;
-	std::cout << "origTargets.size() == " << origTargets.size() << std::endl;
-	std::cout << "attackVal = " << attackVal << "\n\n" << std::endl;
-	}
-
-	}
-	else
-	{
-	attackVal = newTargets.size();
-
-	if (AI_DEBUG)
-	{
-	std::cout << "\n\n==========DEBUG==========\norigTargets.size() == 0\n";
-	std::cout << "newTargets.size() == " << newTargets.size() << std::endl;
-	std::cout << "attackVal = " << attackVal << "\n\n" << std::endl;
-	}
-
-	}
-	if (AI_DEBUG && attackVal > 10)
-	{
-	std::cout << "\n\n========DEBUG=========\nattackVal has large value!!! (" << attackVal << ")\n\n" << std::endl;
-	std::cin.get();
-	}
-	*/
-
-	//	Determine checkValue
-
-	//	Idea:	Determine enemy king's position relative to piece's original position, as well as to the new position.
-	//			From here, if the original position was within "eye-sight" of the enemy king, scan behind the piece being moved for
-	//			a discover check.  Next, determine if the piece would be attacking the king from its new position.  If the attacker
-	//			is a knight, scan to see if the attacker is within a 3-city block distance of the king, excluding purely
-	//			horizontal or vertical travel.  This should be enough to determine check.  Return a vector containing the checking
-	//			pieces, so the checkValue can be larger when there are multiple checking pieces.
-
-	std::vector<chessPiece*> checkingPieces = getCheckers(board, moveData);
-
-	if (checkingPieces.size() == 1)
-	{
-		moveData->moveTypeList.push_back(action::CHECK);
-		checkVal = 2;
-	}
-	else if (checkingPieces.size() > 1)
-	{
-		moveData->moveTypeList.push_back(action::DOUBLE_CHECK);
-		checkVal = 5;
-	}
-	else
-		checkVal = 0;
-
-	if (captureVal >= 0 && checkVal > 0)
-		return captureVal + checkVal;
-
-	//	Determine forwardMovementVal
-	if (moveData->piece->getColor() == WHITE)
-	{
-		//	White moves up the board, so if destR > origR, then from white's perspective it has moved forward.
-		forwardMovementVal = double(moveData->destR - moveData->origR);
-	}
-	else if (moveData->piece->getColor() == BLACK)
-	{
-		//	Black moves down the board, so if origR > destR, then from black's perspective it has moved forward.
-		forwardMovementVal = double(moveData->origR - moveData->destR);
-	}
-
-	if (forwardMovementVal >= 0.0)
-		moveData->moveTypeList.push_back(action::FORWARD);
-	else
-		moveData->moveTypeList.push_back(action::BACKWARD);
-
-	//	This has been phased out in favor of piece-position value tables, as implemented below.
-	/*
-	//	Determine centerControlVal
-	double origCenterControl, destCenterControl;
-	//	The greater the distance from the center, the greater the penalty - except for the king.
-	//	Distance = abs(position - 3.5)
-
-	origCenterControl = abs(moveData->origC - 3.5) + abs(moveData->origR - 3.5);
-	destCenterControl = abs(moveData->destC - 3.5) + abs(moveData->destR - 3.5);
-
-	//	If the destination square is further away from the orig square, then a negative value is appropriate.
-	centerControlVal = (origCenterControl - destCenterControl) / 2;
-
-	//	It can be important for the king to move to the center at times (like near the end game), so lessen the penalty.
-	if (moveData->piece->getType() == KING)
-	centerControlVal = -centerControlVal / 4;
-
-	*/
-
-	//	Determine kingDefenseVal
-	std::vector<std::pair<chessPiece*, PIN_DIR>>* defenders = board.getDefenderVector();
-
-	double origDefenseVal = defenders->size() / 8.0;
-
-	double destDefenseVal = getDefenders(board, moveData, defenders).size() / 8.0;
-
-	double castleMultiplier = 1.0;
-
-	if (moveData->piece->getType() == KING && abs(moveData->origC - moveData->destC) == 2)
-	{
-		moveData->moveTypeList.push_back(action::CASTLE);
-		castleMultiplier = 10.0;
-	}
-
-
-	kingDefenseVal = 100 * castleMultiplier * (destDefenseVal + origDefenseVal) / 2;
-
-	//	Determine pawnPromotion
-	pawnPromotion = getNetPawnPromotion(board, moveData);
-
-	if (int(pawnPromotion) > 0)
-		moveData->moveTypeList.push_back(action::PROMOTION);
-
-
-	//	Determine positional value.
-	bool midgame = false;
-	bool endgame = false;
-
-	if (board.getWhiteQueens()->size() >= 1 || board.getBlackQueens()->size() >= 1)
-	{
-		if (board.getWhiteKnights()->empty() && board.getWhiteBishops()->empty() && board.getWhiteRooks()->empty())
-		{
-			if (board.getBlackKnights()->empty() && board.getBlackBishops()->empty() && board.getBlackRooks()->empty())
-				endgame = true;
-		}
-	}
-	else if (board.getWhiteQueens()->empty() && board.getBlackQueens()->empty())
-	{
-		if ((board.getWhiteKnights()->size() + board.getWhiteBishops()->size() + board.getWhiteRooks()->size()) <= 2)
-			if ((board.getBlackKnights()->size() + board.getBlackBishops()->size() + board.getBlackRooks()->size()) <= 2)
-				endgame = true;
-	}
-
-	PIECE_COLOR color = moveData->piece->getColor();
-	PIECE_TYPE type = moveData->piece->getType();
-
-	if (!endgame) midgame = true;
-
-	if (color == WHITE)
-		switch (type)
-		{
-		case PAWN:
-			positionVal = pawnPosValue[7 - moveData->destR][moveData->destC] - pawnPosValue[7 - moveData->origR][moveData->origC];
-			break;
-		case KNIGHT:
-			positionVal = knightPosValue[7 - moveData->destR][moveData->destC] - knightPosValue[7 - moveData->origR][moveData->origC];
-			break;
-		case BISHOP:
-			positionVal = bishopPosValue[7 - moveData->destR][moveData->destC] - bishopPosValue[7 - moveData->origR][moveData->origC];
-			break;
-		case ROOK:
-			positionVal = rookPosValue[7 - moveData->destR][moveData->destC] - rookPosValue[7 - moveData->origR][moveData->origC];
-			break;
-		case QUEEN:
-			positionVal = queenPosValue[7 - moveData->destR][moveData->destC] - queenPosValue[7 - moveData->origR][moveData->origC];
-			break;
-		case KING:
-			if (midgame) positionVal = kingPosValue_MID[7 - moveData->destR][moveData->destC] - kingPosValue_MID[7 - moveData->origR][moveData->origC];
-			else if (endgame) positionVal = kingPosValue_END[7 - moveData->destR][moveData->destC] - kingPosValue_END[7 - moveData->origR][moveData->origC];
-		}
-	else if (color == BLACK)
-		switch (type)
-		{
-		case PAWN:
-			positionVal = pawnPosValue[moveData->destR][moveData->destC] - pawnPosValue[moveData->origR][moveData->origC];
-			break;
-		case KNIGHT:
-			positionVal = knightPosValue[moveData->origR][moveData->origC] - knightPosValue[moveData->origR][moveData->origC];
-			break;
-		case BISHOP:
-			positionVal = bishopPosValue[moveData->origR][moveData->origC] - bishopPosValue[moveData->origR][moveData->origC];
-			break;
-		case ROOK:
-			positionVal = rookPosValue[moveData->origR][moveData->origC] - rookPosValue[moveData->origR][moveData->origC];
-			break;
-		case QUEEN:
-			positionVal = queenPosValue[moveData->origR][moveData->origC] - queenPosValue[moveData->origR][moveData->origC];
-			break;
-		case KING:
-			if (midgame) positionVal = kingPosValue_MID[moveData->origR][moveData->origC] - kingPosValue_MID[moveData->origR][moveData->origC];
-			else if (endgame) positionVal = kingPosValue_END[moveData->origR][moveData->origC] - kingPosValue_END[moveData->origR][moveData->origC];
-		}
-
-	//	Return heuristic value
-	int total = 100 * forwardMovementVal + kingDefenseVal + pawnPromotion + 100 * positionVal;
-	return total;
-
-}
-
-/*
-	====================================
-	evaluateHeuristic - Helper Functions
-	====================================
-*/
-
-//	Returns a vector containing all of the pieces that moveData->piece is attacking from (moveData->origC, moveData->origR).
-std::vector<chessPiece*> chessGameTree::getTargets(chessBoardClass& board, action* moveData)
-{
-	PIECE_COLOR color = moveData->piece->getColor();
-	PIECE_TYPE type = moveData->piece->getType();
-	std::vector<chessPiece*> targets;
-
-	if (type == PAWN)
-	{
-		if (color == WHITE)
-		{
-			chessPiece* target1 = board.getSquareContents(moveData->origC - 1, moveData->origR + 1);
-			chessPiece* target2 = board.getSquareContents(moveData->origC + 1, moveData->origR + 1);
-
-			if (target2 != NULL && color != target2->getColor())
-				targets.push_back(target1);
-
-			if (target2 != NULL && color != target2->getColor())
-				targets.push_back(target2);
-		}
-		else if (color == BLACK)
-		{
-			chessPiece* target1 = board.getSquareContents(moveData->origC - 1, moveData->origR - 1);
-			chessPiece* target2 = board.getSquareContents(moveData->origC + 1, moveData->origR - 1);
-
-			if (target1 != NULL && color != target1->getColor())
-				targets.push_back(target1);
-
-			if (target2 != NULL && color != target2->getColor())
-				targets.push_back(target2);
-		}
-	}
-	else if (type == KNIGHT)
-	{
-		std::vector<chessPiece*> potentialTargets;
-
-		//	Case 1:  Up 1 - Right 2
-		potentialTargets.push_back(board.getSquareContents(moveData->origC + 2, moveData->origR + 1));
-		//	Case 2:  Up 2 - Right 1
-		potentialTargets.push_back(board.getSquareContents(moveData->origC + 1, moveData->origR + 2));
-		//	Case 3:  Up 2 - Left 1
-		potentialTargets.push_back(board.getSquareContents(moveData->origC - 1, moveData->origR + 2));
-		//	Case 4:  Up 1 - Left 2
-		potentialTargets.push_back(board.getSquareContents(moveData->origC - 2, moveData->origR + 1));
-		//	Case 5:  Down 1 - Left 2
-		potentialTargets.push_back(board.getSquareContents(moveData->origC - 2, moveData->origR - 1));
-		//	Case 6:	 Down 2 - Left 1
-		potentialTargets.push_back(board.getSquareContents(moveData->origC - 1, moveData->origR - 2));
-		//	Case 7:  Down 2 - Right 1
-		potentialTargets.push_back(board.getSquareContents(moveData->origC + 1, moveData->origR - 2));
-		//	Case 8:  Down 1 - Right 2
-		potentialTargets.push_back(board.getSquareContents(moveData->origC + 2, moveData->origR - 1));
-
-		for (int i = 0; i < potentialTargets.size(); ++i)
-		{
-			//	Only add enemy targets to vector - null values and friendlies are ignored.
-			if (potentialTargets[i] != NULL && color != potentialTargets[i]->getColor())
-				targets.push_back(potentialTargets[i]);
-		}
-	}
-	else if (type == BISHOP)
-	{
-		//	Case 1:  Up-Right
-		for (int tracerC = moveData->origC + 1, tracerR = moveData->origR + 1; tracerC <= 7 && tracerR <= 7; ++tracerC, ++tracerR)
-		{
-			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-			if (scanner != NULL)
-			{
-				if (color != scanner->getColor())
-					targets.push_back(scanner);
-				break;
-			}
-		}
-
-		//	Case 2:  Up-Left
-		for (int tracerC = moveData->origC - 1, tracerR = moveData->origR + 1; tracerC >= 0 && tracerR <= 7; --tracerC, ++tracerR)
-		{
-			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-			if (scanner != NULL)
-			{
-				if (color != scanner->getColor())
-					targets.push_back(scanner);
-				break;
-			}
-		}
-
-		//	Case 3:  Down-Left
-		for (int tracerC = moveData->origC - 1, tracerR = moveData->origR - 1; tracerC >= 0 && tracerR >= 0; --tracerC, --tracerR)
-		{
-			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-			if (scanner != NULL)
-			{
-				if (color != scanner->getColor())
-					targets.push_back(scanner);
-				break;
-			}
-		}
-
-		//	Case 4:  Down-Right
-		for (int tracerC = moveData->origC + 1, tracerR = moveData->origR - 1; tracerC <= 7 && tracerR >= 0; ++tracerC, -tracerR)
-		{
-			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-			if (scanner != NULL)
-			{
-				if (color != scanner->getColor())
-					targets.push_back(scanner);
-				break;
-			}
-		}
-	}
-	else if (type == ROOK)
-	{
-		//	Case 1:  Right
-		for (int tracerC = moveData->origC + 1, tracerR = moveData->origR; tracerC <= 7; ++tracerC)
-		{
-			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-			if (scanner != NULL)
-			{
-				if (color != scanner->getColor())
-					targets.push_back(scanner);
-				break;
-			}
-		}
-
-		//	Case 2:  Up
-		for (int tracerC = moveData->origC, tracerR = moveData->origR + 1; tracerR <= 7; ++tracerR)
-		{
-			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-			if (scanner != NULL)
-			{
-				if (color != scanner->getColor())
-					targets.push_back(scanner);
-				break;
-			}
-		}
-
-		//	Case 3:  Left
-		for (int tracerC = moveData->origC - 1, tracerR = moveData->origR; tracerC >= 0; --tracerC)
-		{
-			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-			if (scanner != NULL)
-			{
-				if (color != scanner->getColor())
-					targets.push_back(scanner);
-				break;
-			}
-		}
+		//	Case 1:  Up 1 - Right 2
+		potentialTargets.push_back(board.getSquareContents(moveData->origC + 2, moveData->origR + 1));
+		//	Case 2:  Up 2 - Right 1
+		potentialTargets.push_back(board.getSquareContents(moveData->origC + 1, moveData->origR + 2));
+		//	Case 3:  Up 2 - Left 1
+		potentialTargets.push_back(board.getSquareContents(moveData->origC - 1, moveData->origR + 2));
+		//	Case 4:  Up 1 - Left 2
+		potentialTargets.push_back(board.getSquareContents(moveData->origC - 2, moveData->origR + 1));
+		//	Case 5:  Down 1 - Left 2
+		potentialTargets.push_back(board.getSquareContents(moveData->origC - 2, moveData->origR - 1));
+		//	Case 6:	 Down 2 - Left 1
+		potentialTargets.push_back(board.getSquareContents(moveData->origC - 1, moveData->origR - 2));
+		//	Case 7:  Down 2 - Right 1
+		potentialTargets.push_back(board.getSquareContents(moveData->origC + 1, moveData->origR - 2));
+		//	Case 8:  Down 1 - Right 2
+		potentialTargets.push_back(board.getSquareContents(moveData->origC + 2, moveData->origR - 1));
 
-		//	Case 4:  Down
-		for (int tracerC = moveData->origC, tracerR = moveData->origR - 1; tracerR >= 0; --tracerR)
+		for (int i = 0; i < potentialTargets.size(); ++i)
 		{
-			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-			if (scanner != NULL)
-			{
-				if (color != scanner->getColor())
-					targets.push_back(scanner);
-				break;
-			}
+			//	Only add enemy targets to vector - null values and friendlies are ignored.
+			if (potentialTargets[i] != NULL && color != potentialTargets[i]->getColor())
+				targets.push_back(potentialTargets[i]);
 		}
 	}
-	else if (type == QUEEN)
+	else if (type == BISHOP)
 	{
-
-		//	Case 1:  Right
-		for (int tracerC = moveData->origC + 1, tracerR = moveData->origR; tracerC <= 7; ++tracerC)
-		{
-			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-			if (scanner != NULL)
-			{
-				if (color != scanner->getColor())
-					targets.push_back(scanner);
-				break;
-			}
-		}
-		//	Case 2:  Up-Right
+		//	Case 1:  Up-Right
 		for (int tracerC = moveData->origC + 1, tracerR = moveData->origR + 1; tracerC <= 7 && tracerR <= 7; ++tracerC, ++tracerR)
 		{
 			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
@@ -2125,909 +1077,276 @@ std::vector<chessPiece*> chessGameTree::getTargets(chessBoardClass& board, actio
 				break;
 			}
 		}
-		//	Case 3:  Up
-		for (int tracerC = moveData->origC, tracerR = moveData->origR + 1; tracerR <= 7; ++tracerR)
-		{
-			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-			if (scanner != NULL)
-			{
-				if (color != scanner->getColor())
-					targets.push_back(scanner);
-				break;
-			}
-		}
-		//	Case 4:  Up-Left
-		for (int tracerC = moveData->origC - 1, tracerR = moveData->origR + 1; tracerC >= 0 && tracerR <= 7; --tracerC, ++tracerR)
-		{
-			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-			if (scanner != NULL)
-			{
-				if (color != scanner->getColor())
-					targets.push_back(scanner);
-				break;
-			}
-		}
-		//	Case 5:  Left
-		for (int tracerC = moveData->origC - 1, tracerR = moveData->origR; tracerC >= 0; --tracerC)
-		{
-			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-			if (scanner != NULL)
-			{
-				if (color != scanner->getColor())
-					targets.push_back(scanner);
-				break;
-			}
-		}
-		//	Case 6:  Down-Left
-		for (int tracerC = moveData->origC - 1, tracerR = moveData->origR - 1; tracerC >= 0 && tracerR >= 0; --tracerC, --tracerR)
-		{
-			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-			if (scanner != NULL)
-			{
-				if (color != scanner->getColor())
-					targets.push_back(scanner);
-				break;
-			}
-		}
-		//	Case 7:  Down
-		for (int tracerC = moveData->origC, tracerR = moveData->origR - 1; tracerR >= 0; --tracerR)
-		{
-			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-			if (scanner != NULL)
-			{
-				if (color != scanner->getColor())
-					targets.push_back(scanner);
-				break;
-			}
-		}
-		//	Case 8:  Down-Right
-		for (int tracerC = moveData->origC + 1, tracerR = moveData->origR - 1; tracerC <= 7 && tracerR >= 0; ++tracerC, -tracerR)
-		{
-			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-			if (scanner != NULL)
-			{
-				if (color != scanner->getColor())
-					targets.push_back(scanner);
-				break;
-			}
-		}
-	}
-	else if (type == KING)
-	{
-		//	For now we'll leave this blank, to add some discouragement for the AI using the king offensively.
-	}
-
-
-	return targets;
-}
-
-//	Returns a vector containing all of the pieces that are checking the enemy king after moveData->piece has moved to (moveData->destC, moveData->destR).
-std::vector<chessPiece*> chessGameTree::getCheckers(chessBoardClass& board, action* moveData)
-{
-	//	We'll use PIN_DIR to mark the direction piece is originally, relative to the king.
-	PIN_DIR origDirection = PIN_DIR(-1);
-
-	PIECE_COLOR color = moveData->piece->getColor();
-
-	chessPiece* enemyKing;
-	if (color == WHITE)
-		enemyKing = &(*board.getBlackKing())[0];
-	else // (color == "black")
-		enemyKing = &(*board.getWhiteKing())[0];
-
-	int kingCol = enemyKing->getColumn();
-	int kingRow = enemyKing->getRow();
-
-
-	if (kingRow == moveData->origR)	//	Check for same row
-	{
-		if (kingCol < moveData->origC)	// Piece is to the right of the king.
-			origDirection = RIGHT;
-		else
-			origDirection = LEFT;		// Piece is to the left of the king.
-	}//	Check for same column
-	else if (kingCol == moveData->origC)
-	{
-		if (kingRow < moveData->origC)	// Piece is above the king.
-			origDirection = UP;
-		else
-			origDirection = DOWN;		// Piece is below the king.
-	}//	Check for same diagonal
-	else if (abs(kingCol - moveData->origC) == abs(kingRow - moveData->origR))
-	{
-		/*
-		Idea of above conditional check:  horizontal distance from king to piece must be equal to vertical distance from king to piece.
-		If the horizontal distance and vertical distance is the same, then a line drawn from king to piece is a line of slope 1, so both
-		pieces must be on the same diagonal.
-
-		As a side note, if the piece and the king are resting on the same diagonal, then we know the piece is not a bishop or a queen, since
-		the player moving piece could not have the king in check at the start of his move.  This same idea applies to the other cases above.
-		*/
-
-		// The piece is to the right of the king.
-		if (kingCol < moveData->origC)
-		{
-			if (kingRow < moveData->origR)
-				origDirection = UP_RIGHT;	// The piece is to the up-right of the king
-			else
-				origDirection = DOWN_RIGHT;	// The piece is to the down-right of the king
-		}
-		else // The piece is to the left of the king.
-		{
-			if (kingRow < moveData->origR)
-				origDirection = UP_LEFT;	// The piece is to the up-left of the king
-			else
-				origDirection = DOWN_LEFT;	// The piece is to the down-left of the king
-		}
-	}
-
-	std::vector<chessPiece*> checkers;
-
-	//	If origDirection has been set to a cardinal direction, then a discovered check is possible and needs to be scanned for.
-	if (origDirection == RIGHT || origDirection == UP || origDirection == LEFT || origDirection == DOWN)
-	{
-		//	Discovered check threats:  Queen, Rook.
-
-		if (origDirection == RIGHT)
-		{
-			for (int tracerC = moveData->origC + 1, tracerR = moveData->origR; tracerC <= 7; ++tracerC)
-			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (color != scanner->getColor() && (scanner->getType() == ROOK || scanner->getType() == QUEEN))
-					{
-						checkers.push_back(scanner);
-						break;
-					}
-					else
-						break;
-				}
-			}
-		}
-		else if (origDirection == UP)
-		{
-			for (int tracerC = moveData->origC, tracerR = moveData->origR + 1; tracerR <= 7; ++tracerR)
-			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (color != scanner->getColor() && (scanner->getType() == ROOK || scanner->getType() == QUEEN))
-					{
-						checkers.push_back(scanner);
-						break;
-					}
-					else
-						break;
-				}
-			}
-		}
-		else if (origDirection == LEFT)
-		{
-			for (int tracerC = moveData->origC - 1, tracerR = moveData->origR; tracerC >= 0; --tracerC)
-			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (color != scanner->getColor() && (scanner->getType() == ROOK || scanner->getType() == QUEEN))
-					{
-						checkers.push_back(scanner);
-						break;
-					}
-					else
-						break;
-				}
-			}
-		}
-		else if (origDirection == DOWN)
-		{
-			for (int tracerC = moveData->origC, tracerR = moveData->origR - 1; tracerR >= 0; --tracerR)
-			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (color != scanner->getColor() && (scanner->getType() == ROOK || scanner->getType() == QUEEN))
-					{
-						checkers.push_back(scanner);
-						break;
-					}
-					else
-						break;
-				}
-			}
-		}
-	}
-	else if (origDirection == UP_RIGHT || origDirection == UP_LEFT || origDirection == DOWN_LEFT || origDirection == DOWN_RIGHT)
-	{
-		//	Discovered check threats:  Queen, Bishop.
-		//  Note: Pawns are not a threat, since they cannot be the checker in a discovered check (they'd be out of range).
-
-		if (origDirection == UP_RIGHT)
-		{
-			for (int tracerC = moveData->origC + 1, tracerR = moveData->origR + 1; tracerC <= 7 && tracerR <= 7; ++tracerC, ++tracerR)
-			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (color != scanner->getColor() && (scanner->getType() == BISHOP || scanner->getType() == QUEEN))
-					{
-						checkers.push_back(scanner);
-						break;
-					}
-					else
-						break;
-				}
-			}
-		}
-		else if (origDirection == UP_LEFT)
-		{
-			for (int tracerC = moveData->origC - 1, tracerR = moveData->origR + 1; tracerC >= 0 && tracerR <= 7; --tracerC, ++tracerR)
-			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (color != scanner->getColor() && (scanner->getType() == BISHOP || scanner->getType() == QUEEN))
-					{
-						checkers.push_back(scanner);
-						break;
-					}
-					else
-						break;
-				}
-			}
-		}
-		else if (origDirection == DOWN_LEFT)
-		{
-			for (int tracerC = moveData->origC - 1, tracerR = moveData->origR - 1; tracerC >= 0 && tracerR >= 0; --tracerC, --tracerR)
-			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (color != scanner->getColor() && (scanner->getType() == BISHOP || scanner->getType() == QUEEN))
-					{
-						checkers.push_back(scanner);
-						break;
-					}
-					else
-						break;
-				}
-			}
-		}
-		else if (origDirection == DOWN_RIGHT)
-		{
-			for (int tracerC = moveData->origC + 1, tracerR = moveData->origR - 1; tracerC <= 7 && tracerR >= 0; ++tracerC, --tracerR)
-			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (color != scanner->getColor() && (scanner->getType() == BISHOP || scanner->getType() == QUEEN))
-					{
-						checkers.push_back(scanner);
-						break;
-					}
-					else
-						break;
-				}
-			}
-		}
-	}
-
-	//	Discovered checks are all scanned for.  Now we need to see if the piece's new position leads to a check.
-
-	PIECE_TYPE type = moveData->piece->getType();
 
-	if (type == PAWN)
-	{
-		if (color == WHITE)
-		{
-			if (kingCol == moveData->destC - 1 && kingRow == moveData->destR + 1)	//	King is up-left of white pawn.
-				checkers.push_back(moveData->piece);
-			else if (kingCol == moveData->destC + 1 && kingRow == moveData->destR + 1)	//	King is up-right of white pawn.
-				checkers.push_back(moveData->piece);
-		}
-		else // color == "black"
-		{
-			if (kingCol == moveData->destC - 1 && kingRow == moveData->destR - 1)	//	King is down-left of black pawn.
-				checkers.push_back(moveData->piece);
-			else if (kingCol == moveData->destC + 1 && kingRow == moveData->destR - 1)	//	King is down-right of black pawn.
-				checkers.push_back(moveData->piece);
-		}
-	}
-	else if (type == KNIGHT)
-	{
-		//	If the city-block distance between the knight and the king is 3...
-		if (((abs(kingRow - moveData->destR)) + (abs(kingCol - moveData->destC))) == 3)
+		//	Case 2:  Up-Left
+		for (int tracerC = moveData->origC - 1, tracerR = moveData->origR + 1; tracerC >= 0 && tracerR <= 7; --tracerC, ++tracerR)
 		{
-			//	... and if the distance is not purely horizontal or vertical...
-			if (kingRow != moveData->destR && kingCol != moveData->destC)
-				checkers.push_back(moveData->piece);	//  ... then the knight is checking the king.
+			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
+
+			if (scanner != NULL)
+			{
+				if (color != scanner->getColor())
+					targets.push_back(scanner);
+				break;
+			}
 		}
-	}
-	else if (type == BISHOP)
-	{
-		//	If bishop is moving to the same diagonal as the king...
-		if (abs(kingRow - moveData->destR) == abs(kingCol - moveData->destC))
+
+		//	Case 3:  Down-Left
+		for (int tracerC = moveData->origC - 1, tracerR = moveData->origR - 1; tracerC >= 0 && tracerR >= 0; --tracerC, --tracerR)
 		{
-			if (kingRow < moveData->destR)		//	Bishop is to move above the king
+			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
+
+			if (scanner != NULL)
 			{
-				if (kingCol < moveData->destC)	//	Bishop is to move to the right of the king.
-				{
-					//	Scan for bishop check on king.
-					for (int tracerC = kingCol + 1, tracerR = kingRow + 1; tracerC <= 7 && tracerR <= 7; ++tracerC, ++tracerR)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
-				else if (kingCol > moveData->destC)	//	Bishop is to move to the left of the king.
-				{
-					for (int tracerC = kingCol - 1, tracerR = kingRow + 1; tracerC >= 0 && tracerR <= 7; --tracerC, ++tracerR)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
+				if (color != scanner->getColor())
+					targets.push_back(scanner);
+				break;
 			}
-			else if (kingRow > moveData->destR)	//	Bishop is to move below the king.
+		}
+
+		//	Case 4:  Down-Right
+		for (int tracerC = moveData->origC + 1, tracerR = moveData->origR - 1; tracerC <= 7 && tracerR >= 0; ++tracerC, -tracerR)
+		{
+			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
+
+			if (scanner != NULL)
 			{
-				if (kingCol < moveData->destC)	//	Bishop is to move to the right of the king.
-				{
-					for (int tracerC = kingCol + 1, tracerR = kingRow - 1; tracerC <= 7 && tracerR >= 0; ++tracerC, --tracerR)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
-				else if (kingCol > moveData->destC)	//	Bishop is to move to the left of the king.
-				{
-					for (int tracerC = kingCol - 1, tracerR = kingRow - 1; tracerC >= 0 && tracerR >= 0; --tracerC, --tracerR)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
+				if (color != scanner->getColor())
+					targets.push_back(scanner);
+				break;
 			}
 		}
 	}
 	else if (type == ROOK)
 	{
-		//	If rook is moving to the same row or column as the king...
-		if (kingRow == moveData->destR || kingCol == moveData->destC)
+		//	Case 1:  Right
+		for (int tracerC = moveData->origC + 1, tracerR = moveData->origR; tracerC <= 7; ++tracerC)
 		{
-			if (kingRow == moveData->destR)	//	//	Rook is on the same row as the king.
-			{
+			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
 
-				if (kingCol < moveData->destC)	//	Rook is to the right of the king.
-				{
-					for (int tracerC = kingCol + 1, tracerR = kingRow; tracerC <= 7; ++tracerC)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
-				else if (kingCol > moveData->destC)	//	Rook is to the left of the king.
-				{
-					for (int tracerC = kingCol - 1, tracerR = kingRow; tracerC >= 0; --tracerC)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
-			}
-			else if (kingCol == moveData->destC)	//	Rook is on the same column as the king.
+			if (scanner != NULL)
 			{
-				if (kingRow < moveData->destR)	//	Rook is above the king.
-				{
-					for (int tracerC = kingCol, tracerR = kingRow + 1; tracerR <= 7; ++tracerR)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
-				else if (kingRow > moveData->destR)	//	Rook is below the king.
-				{
-					for (int tracerC = kingCol, tracerR = kingRow - 1; tracerR >= 0; --tracerR)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
+				if (color != scanner->getColor())
+					targets.push_back(scanner);
+				break;
 			}
 		}
-	}
-	else if (type == QUEEN)
-	{
-		//	If queen is moving to the same diagonal as the king...
-		if (abs(kingRow - moveData->destR) == abs(kingCol - moveData->destC))
+
+		//	Case 2:  Up
+		for (int tracerC = moveData->origC, tracerR = moveData->origR + 1; tracerR <= 7; ++tracerR)
 		{
-			if (kingRow < moveData->destR)		//	Queen is to move above the king
+			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
+
+			if (scanner != NULL)
 			{
-				if (kingCol < moveData->destC)	//	Queen is to move to the right of the king.
-				{
-					//	Scan for queen check on king.
-					for (int tracerC = kingCol + 1, tracerR = kingRow + 1; tracerC <= 7 && tracerR <= 7; ++tracerC, ++tracerR)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
-				else if (kingCol > moveData->destC)	//	Queen is to move to the left of the king.
-				{
-					for (int tracerC = kingCol - 1, tracerR = kingRow + 1; tracerC >= 0 && tracerR <= 7; --tracerC, ++tracerR)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
+				if (color != scanner->getColor())
+					targets.push_back(scanner);
+				break;
 			}
-			else if (kingRow > moveData->destR)	//	Queen is to move below the king.
+		}
+
+		//	Case 3:  Left
+		for (int tracerC = moveData->origC - 1, tracerR = moveData->origR; tracerC >= 0; --tracerC)
+		{
+			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
+
+			if (scanner != NULL)
 			{
-				if (kingCol < moveData->destC)	//	Queen is to move to the right of the king.
-				{
-					for (int tracerC = kingCol + 1, tracerR = kingRow - 1; tracerC <= 7 && tracerR >= 0; ++tracerC, --tracerR)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
-				else if (kingCol > moveData->destC)	//	Queen is to move to the left of the king.
-				{
-					for (int tracerC = kingCol - 1, tracerR = kingRow - 1; tracerC >= 0 && tracerR >= 0; --tracerC, --tracerR)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
+				if (color != scanner->getColor())
+					targets.push_back(scanner);
+				break;
 			}
 		}
-		else if (kingRow == moveData->destR || kingCol == moveData->destC)	//	If queen is moving to the same row or column as the king...
+
+		//	Case 4:  Down
+		for (int tracerC = moveData->origC, tracerR = moveData->origR - 1; tracerR >= 0; --tracerR)
 		{
-			if (kingRow == moveData->destR)	//	//	Queen is on the same row as the king.
-			{
+			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
 
-				if (kingCol < moveData->destC)	//	Queen is to the right of the king.
-				{
-					for (int tracerC = kingCol + 1, tracerR = kingRow; tracerC <= 7; ++tracerC)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
-				else if (kingCol > moveData->destC)	//	Queen is to the left of the king.
-				{
-					for (int tracerC = kingCol - 1, tracerR = kingRow; tracerC >= 0; --tracerC)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
-			}
-			else if (kingCol == moveData->destC)	//	Queen is on the same column as the king.
+			if (scanner != NULL)
 			{
-				if (kingRow < moveData->destR)	//	Queen is above the king.
-				{
-					for (int tracerC = kingCol, tracerR = kingRow + 1; tracerR <= 7; ++tracerR)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
-				else if (kingRow > moveData->destR)	//	Queen is below the king.
-				{
-					for (int tracerC = kingCol, tracerR = kingRow - 1; tracerR >= 0; --tracerR)
-					{
-						chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-						if (scanner != NULL)
-							break;
-
-						if (tracerC == moveData->destC && tracerR == moveData->destR)
-						{
-							checkers.push_back(moveData->piece);
-							break;
-						}
-					}
-				}
+				if (color != scanner->getColor())
+					targets.push_back(scanner);
+				break;
 			}
 		}
 	}
-
-
-	//	All scans complete.  Return vector.
-	return checkers;
-}
-
-//	Returns a vector containing all of the pieces that are in eight-direction eye-sight of the king after moveData->piece has moved to (moveData->destC, moveData->destR).
-std::vector<chessPiece*> chessGameTree::getDefenders(chessBoardClass& board, action* moveData, std::vector<std::pair<chessPiece*, PIN_DIR>>* origDefenders)
-{
-	/*
-	Idea:	Determine cardinal direction of piece's destination square (destC, destR), relative to king's position.
-
-	Case 1:	No cardinal direction can be determined, i.e. piece is not a defender.  origDefenders will have the first element of each pair
-	copied over to a new chessPiece vector, which will contain all of origDefenders with the exception of piece, if present in origDefenders.
-
-	Case 2:	A cardinal direction is determined.  This means that piece's destination lies on the same row, column, or diagonal as the king.
-	We must scan in that direction from the king to determine if piece is now defending the king.
-
-	-	2.1)	If piece is the first chessPiece object encountered during the scan, it is flagged as a defender and added to the defenders
-	if it is not already present (hence the need for the flag).
-	-	2.2)	If anything else is encountered before chessPiece (friendly or enemy), then chessPiece is flagged as not a defender and the
-	function will proceed forward as if Case 1 had occured.
-	*/
-
-	//	We'll use PIN_DIR to mark the direction piece is originally, relative to the king.
-	PIN_DIR destDirection = PIN_DIR(-1);
-
-	PIECE_COLOR color = moveData->piece->getColor();
-
-	chessPiece* king;
-	if (color == WHITE)
-		king = &(*board.getWhiteKing())[0];
-	else // (color == "black")
-		king = &(*board.getBlackKing())[0];
-
-	int kingCol = king->getColumn();
-	int kingRow = king->getRow();
-
-
-	if (kingRow == moveData->origR)	//	Check for same row
-	{
-		if (kingCol < moveData->origC)	// Piece is to the right of the king.
-			destDirection = RIGHT;
-		else
-			destDirection = LEFT;		// Piece is to the left of the king.
-	}//	Check for same column
-	else if (kingCol == moveData->origC)
-	{
-		if (kingRow < moveData->origC)	// Piece is above the king.
-			destDirection = UP;
-		else
-			destDirection = DOWN;		// Piece is below the king.
-	}//	Check for same diagonal
-	else if (abs(kingCol - moveData->origC) == abs(kingRow - moveData->origR))
+	else if (type == QUEEN)
 	{
-		/*
-		Idea of above conditional check:  horizontal distance from king to piece must be equal to vertical distance from king to piece.
-		If the horizontal distance and vertical distance is the same, then a line drawn from king to piece is a line of slope 1, so both
-		pieces must be on the same diagonal.
-
-		As a side note, if the piece and the king are resting on the same diagonal, then we know the piece is not a bishop or a queen, since
-		the player moving piece could not have the king in check at the start of his move.  This same idea applies to the other cases above.
-		*/
 
-		// The piece is to the right of the king.
-		if (kingCol < moveData->origC)
-		{
-			if (kingRow < moveData->origR)
-				destDirection = UP_RIGHT;	// The piece is to the up-right of the king
-			else
-				destDirection = DOWN_RIGHT;	// The piece is to the down-right of the king
-		}
-		else // The piece is to the left of the king.
+		//	Case 1:  Right
+		for (int tracerC = moveData->origC + 1, tracerR = moveData->origR; tracerC <= 7; ++tracerC)
 		{
-			if (kingRow < moveData->origR)
-				destDirection = UP_LEFT;	// The piece is to the up-left of the king
-			else
-				destDirection = DOWN_LEFT;	// The piece is to the down-left of the king
-		}
-	}
-
-	bool isDefender = false;
+			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
 
-	//	If a cardinal direction could not be determined, then piece is not a defender.
-	if (destDirection == PIN_DIR(-1))
-		isDefender = false;
-	else //	If cardinal direction can be determined, see if piece is defending king.
-	{
-		if (destDirection == RIGHT)
-		{
-			for (int tracerC = kingCol + 1, tracerR = kingRow; tracerC <= 7; ++tracerC)
+			if (scanner != NULL)
 			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (scanner == moveData->piece)
-						isDefender = true;
-
-					break;
-				}
+				if (color != scanner->getColor())
+					targets.push_back(scanner);
+				break;
 			}
 		}
-		else if (destDirection == UP_RIGHT)
+		//	Case 2:  Up-Right
+		for (int tracerC = moveData->origC + 1, tracerR = moveData->origR + 1; tracerC <= 7 && tracerR <= 7; ++tracerC, ++tracerR)
 		{
-			for (int tracerC = kingCol + 1, tracerR = kingRow + 1; tracerC <= 7 && tracerR <= 7; ++tracerC, ++tracerR)
-			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (scanner == moveData->piece)
-						isDefender = true;
+			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
 
-					break;
-				}
+			if (scanner != NULL)
+			{
+				if (color != scanner->getColor())
+					targets.push_back(scanner);
+				break;
 			}
 		}
-		else if (destDirection == UP)
+		//	Case 3:  Up
+		for (int tracerC = moveData->origC, tracerR = moveData->origR + 1; tracerR <= 7; ++tracerR)
 		{
-			for (int tracerC = kingCol, tracerR = kingRow + 1; tracerR <= 7; ++tracerR)
-			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (scanner == moveData->piece)
-						isDefender = true;
+			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
 
-					break;
-				}
+			if (scanner != NULL)
+			{
+				if (color != scanner->getColor())
+					targets.push_back(scanner);
+				break;
 			}
 		}
-		else if (destDirection == UP_LEFT)
+		//	Case 4:  Up-Left
+		for (int tracerC = moveData->origC - 1, tracerR = moveData->origR + 1; tracerC >= 0 && tracerR <= 7; --tracerC, ++tracerR)
 		{
-			for (int tracerC = kingCol - 1, tracerR = kingRow + 1; tracerC >= 0 && tracerR <= 7; --tracerC, ++tracerR)
-			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (scanner == moveData->piece)
-						isDefender = true;
+			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
 
-					break;
-				}
+			if (scanner != NULL)
+			{
+				if (color != scanner->getColor())
+					targets.push_back(scanner);
+				break;
 			}
 		}
-		else if (destDirection == LEFT)
+		//	Case 5:  Left
+		for (int tracerC = moveData->origC - 1, tracerR = moveData->origR; tracerC >= 0; --tracerC)
 		{
-			for (int tracerC = kingCol - 1, tracerR = kingRow; tracerC >= 0; --tracerC)
-			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (scanner == moveData->piece)
-						isDefender = true;
+			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
 
-					break;
-				}
+			if (scanner != NULL)
+			{
+				if (color != scanner->getColor())
+					targets.push_back(scanner);
+				break;
 			}
 		}
-		else if (destDirection == DOWN_LEFT)
+		//	Case 6:  Down-Left
+		for (int tracerC = moveData->origC - 1, tracerR = moveData->origR - 1; tracerC >= 0 && tracerR >= 0; --tracerC, --tracerR)
 		{
-			for (int tracerC = kingCol - 1, tracerR = kingRow - 1; tracerC >= 0 && tracerR >= 0; --tracerC, --tracerR)
-			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (scanner == moveData->piece)
-						isDefender = true;
+			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
 
-					break;
-				}
+			if (scanner != NULL)
+			{
+				if (color != scanner->getColor())
+					targets.push_back(scanner);
+				break;
 			}
 		}
-		else if (destDirection == DOWN)
+		//	Case 7:  Down
+		for (int tracerC = moveData->origC, tracerR = moveData->origR - 1; tracerR >= 0; --tracerR)
 		{
-			for (int tracerC = kingCol, tracerR = kingRow - 1; tracerR >= 0; --tracerR)
-			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (scanner == moveData->piece)
-						isDefender = true;
+			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
 
-					break;
-				}
+			if (scanner != NULL)
+			{
+				if (color != scanner->getColor())
+					targets.push_back(scanner);
+				break;
 			}
 		}
-		else if (destDirection == DOWN_RIGHT)
+		//	Case 8:  Down-Right
+		for (int tracerC = moveData->origC + 1, tracerR = moveData->origR - 1; tracerC <= 7 && tracerR >= 0; ++tracerC, -tracerR)
 		{
-			for (int tracerC = kingCol + 1, tracerR = kingRow - 1; tracerC <= 7 && tracerR >= 0; ++tracerC, --tracerR)
-			{
-				chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
-
-				if (scanner != NULL)
-				{
-					if (scanner == moveData->piece)
-						isDefender = true;
+			chessPiece* scanner = board.getSquareContents(tracerC, tracerR);
 
-					break;
-				}
+			if (scanner != NULL)
+			{
+				if (color != scanner->getColor())
+					targets.push_back(scanner);
+				break;
 			}
 		}
 	}
+	else if (type == KING)
+	{
+		//	For now we'll leave this blank, to add some discouragement for the AI using the king offensively.
+	}
 
-	std::vector<chessPiece*> defenders;
 
-	if (isDefender)
-		defenders.push_back(moveData->piece);
+	return targets;
+}
 
-	for (int i = 0; i < origDefenders->size(); ++i)
-	{
-		chessPiece* defender = (*origDefenders)[i].first;
-		PIN_DIR origDirection = (*origDefenders)[i].second;
+//	Returns the number of pieces that would be checking the enemy king once move has been played, discovered checks included.
+int chessGameTree::countCheckers(chessBoardClass& board, chessMove move)
+{
+	int from = move.getFrom(), to = move.getTo();
+	chessPiece* piece = board.getSquareContents(move.getOrigC(), move.getOrigR());
 
-		//	Note:	If piece has been determined to be a defender, it is possible that piece has 'replaced' a defender
-		//			by moving between the original defender and the king.  This should be checked for (destDirection != origDirection).
+	PIECE_COLOR color = piece->getColor();
+	PIECE_COLOR enemy = (color == WHITE) ? BLACK : WHITE;
 
-		if (isDefender && destDirection != origDirection && defender != moveData->piece)
-			defenders.push_back(defender);
-	}
+	int enemyKing = lowestSquare(board.getPieces(enemy, KING));
+
+	//	Work out where the moving side's pieces stand, and which squares are occupied, after the move.
+	bitboard occupied = (board.getOccupied() & ~squareBit(from)) | squareBit(to);
+	bitboard pieces[6];
+
+	for (int type = PAWN; type <= KING; ++type)
+		pieces[type] = board.getPieces(color, PIECE_TYPE(type)) & ~squareBit(from);
+
+	if (move.getFlag() == PROMOTION_MOVE)
+		pieces[move.getPromotion()] |= squareBit(to);
+	else
+		pieces[piece->getType()] |= squareBit(to);
 
-	if (defenders.empty())
+	if (move.getFlag() == EN_PASSANT_MOVE)
+		occupied &= ~squareBit(squareIndex(move.getDestC(), move.getOrigR()));
+	else if (move.getFlag() == CASTLE_MOVE)
 	{
-		for (int i = 0; i < origDefenders->size(); ++i)
-			defenders.push_back((*origDefenders)[i].first);
+		//	The rook comes from its corner and lands on the square the king passed over.
+		int rookFrom = (to > from) ? from + 3 : from - 4;
+		int rookTo = (from + to) / 2;
+
+		occupied = (occupied & ~squareBit(rookFrom)) | squareBit(rookTo);
+		pieces[ROOK] = (pieces[ROOK] & ~squareBit(rookFrom)) | squareBit(rookTo);
 	}
 
-	return defenders;
+	bitboard checkers = (pawnAttacks(enemy, enemyKing) & pieces[PAWN])
+		| (knightAttacks(enemyKing) & pieces[KNIGHT])
+		| (bishopAttacks(enemyKing, occupied) & (pieces[BISHOP] | pieces[QUEEN]))
+		| (rookAttacks(enemyKing, occupied) & (pieces[ROOK] | pieces[QUEEN]));
+
+	return popCount(checkers);
 }
 
-//	Returns a double value conveying the net gain in material from promoting a pawn.
-///	NOTE:  AI WILL ALWAYS PROMOTE TO QUEEN, UNLESS PROMOTION IS SPECIFICALLY IMPLEMENTED AS AN ACTION LATER ON.
-double chessGameTree::getNetPawnPromotion(chessBoardClass& board, action* moveData)
+//	Returns the number of friendly pieces in eight-direction eye-sight of the king once move has been played.
+int chessGameTree::countDefenders(chessBoardClass& board, chessMove move)
 {
-	if (moveData->piece->getType() != PAWN)
-		return 0.0;
+	int from = move.getFrom(), to = move.getTo();
+	chessPiece* piece = board.getSquareContents(move.getOrigC(), move.getOrigR());
 
-	PIECE_COLOR color = moveData->piece->getColor();
-	int destR = moveData->piece->getRow();
+	PIECE_COLOR color = piece->getColor();
 
-	//	Technically this is frivolous, since only white pawns can reach row 7 (and only black pawns can reach row 0),
-	//	but it helps to convey meaning and increase readability.
-	if (color == WHITE)
-	{
-		if (destR == 7)
-			return val.queen - 6.0;
-		else
-			return 0.0;
-	}
-	else // color == "black"
+	bitboard friendly = (board.getPieces(color) & ~squareBit(from)) | squareBit(to);
+	bitboard occupied = (board.getOccupied() & ~squareBit(from)) | squareBit(to);
+
+	if (move.getFlag() == EN_PASSANT_MOVE)
+		occupied &= ~squareBit(squareIndex(move.getDestC(), move.getOrigR()));
+	else if (move.getFlag() == CASTLE_MOVE)
 	{
-		if (destR == 0)
-			return val.queen - 6.0;
-		else
-			return 0.0;
+		bitboard rookMove = squareBit((to > from) ? from + 3 : from - 4) | squareBit((from + to) / 2);
+
+		friendly ^= rookMove;
+		occupied ^= rookMove;
 	}
 
+	int king = (piece->getType() == KING) ? to : lowestSquare(board.getPieces(color, KING));
+
+	return popCount(queenAttacks(king, occupied) & friendly);
 }
 
 /*
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "chessBoardClass.h"
+#include "chessTranspositionTable.h"
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
 
 ///	 Various Notes and Thoughts  \\\
 
@@ -172,85 +176,99 @@ struct gameStateNode
 	void init(gameStateNode* node);
 };
 
-//	Contains pure, standard piece values, independent of position.
-const struct pieceValues
+//	Limits on a single search.  Anything left at 0 is not a limit; with nothing set, the search goes as deep as the tree's maxDepth.
+struct searchLimits
 {
-	int pawn = 100;
-	int knight = 300;
-	int bishop = 300;
-	int rook = 500;
-	int queen = 900;
-	int king = 100000;	// Might not be needed, but included for consistency's sake.
-} val;
-
-//	Below are the positional values for each piece type.  They are used for evaluating the quality of a sequence of moves, based on the strength of the piece positions.
-const int pawnPosValue[8][8] = { 0,  0,  0,  0,  0,  0,  0,  0,
-								50, 50, 50, 50, 50, 50, 50, 50,
-								10, 10, 20, 30, 30, 20, 10, 10,
-								5,  5, 10, 25, 25, 10,  5,  5,
-								0,  0,  0, 20, 20,  0,  0,  0,
-								5, -5,-10,  0,  0,-10, -5,  5,
-								5, 10, 10,-20,-20, 10, 10,  5,
-								0,  0,  0,  0,  0,  0,  0,  0 };
-
-const int knightPosValue[8][8] = {	-50,-40,-30,-30,-30,-30,-40,-50,
-									-40,-20,  0,  0,  0,  0,-20,-40,
-									-30,  0, 10, 15, 15, 10,  0,-30,
-									-30,  5, 15, 20, 20, 15,  5,-30,
-									-30,  0, 15, 20, 20, 15,  0,-30,
-									-30,  5, 10, 15, 15, 10,  5,-30,
-									-40,-20,  0,  5,  5,  0,-20,-40,
-									-50,-40,-30,-30,-30,-30,-40,-50 };
-
-const int bishopPosValue[8][8] = {	-20,-10,-10,-10,-10,-10,-10,-20,
-									-10,  0,  0,  0,  0,  0,  0,-10,
-									-10,  0,  5, 10, 10,  5,  0,-10,
-									-10,  5,  5, 10, 10,  5,  5,-10,
-									-10,  0, 10, 10, 10, 10,  0,-10,
-									-10, 10, 10, 10, 10, 10, 10,-10,
-									-10,  5,  0,  0,  0,  0,  5,-10,
-									-20,-10,-10,-10,-10,-10,-10,-20 };
-
-const int rookPosValue[8][8] = {	0,  0,  0,  0,  0,  0,  0,  0,
-									5, 10, 10, 10, 10, 10, 10,  5,
-								   -5,  0,  0,  0,  0,  0,  0, -5,
-								   -5,  0,  0,  0,  0,  0,  0, -5,
-								   -5,  0,  0,  0,  0,  0,  0, -5,
-								   -5,  0,  0,  0,  0,  0,  0, -5,
-								   -5,  0,  0,  0,  0,  0,  0, -5,
-									0,  0,  0,  5,  5,  0,  0,  0 };
-
-const int queenPosValue[8][8] = {	-20,-10,-10, -5, -5,-10,-10,-20,
-									-10,  0,  0,  0,  0,  0,  0,-10,
-									-10,  0,  5,  5,  5,  5,  0,-10,
-									-5,  0,  5,  5,  5,  5,  0, -5,
-									 0,  0,  5,  5,  5,  5,  0, -5,
-									-10,  5,  5,  5,  5,  5,  0,-10,
-									-10,  0,  5,  0,  0,  0,  0,-10,
-									-20,-10,-10, -5, -5,-10,-10,-20 };
-
-
-const int kingPosValue_MID[8][8] = {	-30,-40,-40,-50,-50,-40,-40,-30,
-										-30,-40,-40,-50,-50,-40,-40,-30,
-										-30,-40,-40,-50,-50,-40,-40,-30,
-										-30,-40,-40,-50,-50,-40,-40,-30,
-										-20,-30,-30,-40,-40,-30,-30,-20,
-										-10,-20,-20,-20,-20,-20,-20,-10,
-										 20, 20,  0,  0,  0,  0, 20, 20,
-										 20, 30, 10,  0,  0, 10, 30, 20 };
-
-//	King positional values change during the end game to encourage the AI to move the king up the board to support in pawn promotion.
-const int kingPosValue_END[8][8] = {	-50,-40,-30,-20,-20,-30,-40,-50,
-										-30,-20,-10,  0,  0,-10,-20,-30,
-										-30,-10, 20, 30, 30, 20,-10,-30,
-										-30,-10, 30, 40, 40, 30,-10,-30,
-										-30,-10, 30, 40, 40, 30,-10,-30,
-										-30,-10, 20, 30, 30, 20,-10,-30,
-										-30,-30,  0,  0,  0,  0,-30,-30,
-										-50,-30,-30,-30,-30,-30,-30,-50 };
+	int depth = 0;			// Deepest iteration to search.
+	int moveTime = 0;		// Milliseconds to spend on this move, no more and no less.
+	int timeLeft = 0;		// Milliseconds left on the clock of the side to move.
+	int increment = 0;		// Milliseconds added to that clock after every move.
+	int movesToGo = 0;		// Moves left until the next time control, or 0 if the rest of the game is played on timeLeft.
+	std::uint64_t nodes = 0;	// Positions the main thread may visit.
+	bool infinite = false;	// Keep going deeper until requestStop() is called.
+};
+
+//	Deepest a line can go from the root of the search, not counting the quiescence search.
+const int MAX_PLY = 128;
+
+//	Everything one search thread keeps to itself.  The transposition table is the only thing the threads share.
+struct searchWorker
+{
+	chessBoardClass board;		// The thread's own copy of the position, which it makes and unmakes moves on.
+	std::atomic<std::uint64_t> nodeCount;	// Number of positions the thread has visited during the search.  Only the thread itself writes it.
+	chessMove rootMove;			// Best move at the root of the iteration the thread is searching.
+	int id;						// 0 for the main thread, which keeps the clock and picks the move; helpers count up from 1.
+
+	//	What the search has learned about quiet moves (neither captures nor promotions), for ordering them.
+	chessMove killers[MAX_PLY][2];		// The last two quiet moves to cause a beta cut-off at each ply, most recent first.
+	chessMove counterMoves[64][64];		// The quiet move that last refuted the move from one square (first index) to another.
+	int history[2][64][64];				// How well a quiet move from one square to another has done for a color, weighted by depth.
+	chessMove currentMoves[MAX_PLY];	// Move being searched at each ply of the current line.
+
+	searchWorker() : nodeCount(0), id(0)
+	{
+		board.init();
+		std::fill(&history[0][0][0], &history[0][0][0] + 2 * 64 * 64, 0);
+	}
+};
+
+class chessGameTree;
+
+//	Hands negamax the legal moves of a position one at a time, most promising first.  Most nodes that cut off do so on
+//	their first move or two, so the moves are written out and scored in stages, and a node that cuts off early never
+//	pays for the moves it didn't get to:
+//
+//	1.	The transposition table's best move, which only has to be checked for legality.
+//	2.	Captures and queen promotions, most valuable victim first and least valuable attacker next (MVV-LVA).  Each one
+//		gets a static exchange test as it comes up, and one that loses material is put aside for stage 5.
+//	3.	The killers for the ply and the countermove to the move that led here, if they are legal quiet moves here.
+//	4.	The rest of the quiet moves, written out only now.  They are scored cheaply, by history and by whether they give
+//		check.  If the first few of them don't cut off either, and the node is deep enough for the ordering to pay, the
+//		rest are scored again with chessGameTree::evaluateHeuristic().
+//	5.	The captures put aside in stage 2.
+class movePicker
+{
+public:
+	movePicker(chessGameTree& tree, searchWorker& worker, int ply, int remainingDepth, chessMove hashMove);
+
+	//	Sets move to the next move to search, returning false once every move has been handed out.
+	bool next(chessMove& move);
+
+private:
+	enum PICK_STAGE { HASH_MOVE, GENERATE_CAPTURES, GOOD_CAPTURES, REFUTATIONS, GENERATE_QUIETS, QUIETS, BAD_CAPTURES, NO_MOVES_LEFT };
+
+	chessGameTree& tree;
+	searchWorker& worker;
+	chessBoardClass& board;
+	int ply;
+	int remainingDepth;
+
+	PICK_STAGE stage;
+	chessMove hashMove;			// Left empty unless the move is legal here.
+	chessMove refutations[3];	// Both killers and the countermove.  Each is emptied if it turns out not to be a legal quiet move here.
+	int refutationIndex;		// Next entry of refutations to hand out.
+
+	moveList moves;				// The captures, then the quiet moves.  Captures put aside are moved to the front, into slots already handed out.
+	int current;				// Next entry of moves to hand out.
+	int badCaptures;			// Number of captures put aside at the front of moves.
+
+	int quietsPicked;			// Number of quiet moves handed out in stage 4.
+	bool fullyScored;			// Set once the quiet moves left have been scored with the full heuristic.
+
+	static const int cheapQuietMoves = 3;	// Quiet moves handed out in the cheap order before the full heuristic is used.
+	static const int fullScoreDepth = 4;	// Least remaining depth at which the full heuristic is used.
+
+	//	Scores the quiet moves not yet handed out with the full heuristic.
+	void scoreQuietsFully();
+
+	//	Returns true if move was already handed out by stage 1 or 3.
+	bool alreadyPicked(chessMove move) const;
+};
 
 class chessGameTree
 {
+	friend class movePicker;
+
 protected:
 	
 
@@ -258,44 +276,76 @@ protected:
 	gameStateNode* currentGameState;	// Points to the current (real) game state node.
 	int maxDepth;						// Maximum depth level the tree is allowed to be built to, relative to the depth of the currentGameState node.
 
+	transpositionTable table;			// What earlier searches found out about positions, kept from one move to the next.
+	std::uint64_t nodeCount;			// Number of positions negamax has visited during the last search, over all threads.
+	int threadCount;					// Number of threads that search at once; 1 searches on the calling thread alone.
 
-	//	Generates the game tree and searches it, using a variation of the minimax algorithm that utilizes alpha-beta pruning.
-	int negamax(gameStateNode* node, int alpha, int beta, int remainingDepth, int color);
+	std::chrono::steady_clock::time_point searchStart;	// When the current search started.
+	long long softLimit;				// Milliseconds after which no new iteration is started, or 0 if the search is not timed.
+	long long hardLimit;				// Milliseconds after which the search is abandoned mid-iteration, or 0 if the search is not timed.
+	std::atomic<bool> stopSearch;		// Set once the hard limit has passed, or the main thread is done; everything negamax returns after that is thrown away.
+	std::atomic<bool> stopRequested;	// Set by requestStop(), from any thread.
+	std::uint64_t nodeLimit;			// Positions the main thread may visit, or 0 if the search is not limited by nodes.
+	int completedDepth;					// Depth of the last iteration the main thread searched to the end.
 
-	int getMax(double lhs, double rhs) { if (lhs >= rhs) return lhs; else return rhs; }
 
-	//	Helper function to negamax - creates a child node for the passed node, returning the address of the new gameStateNode.
-	gameStateNode* generateChildNode(gameStateNode* node, action* actionData);
+	//	Searches the game tree, using a variation of the minimax algorithm that utilizes alpha-beta pruning.
+	//	The tree is walked by making and unmaking moves on a single board, rather than by building a node for every position.
+	//	Scores are from the point of view of the side to move on the worker's board.  ply is the distance from the root of the search.
+	int negamax(searchWorker& worker, int alpha, int beta, int remainingDepth, int ply);
+
+	//	Helper function to negamax - takes over where the depth runs out, playing captures and promotions until the position
+	//	is quiet, so that a leaf is never scored in the middle of an exchange.  A king in check gets all of its moves.
+	int quiescence(searchWorker& worker, int alpha, int beta, int ply);
+
+	//	Counts a position as visited by worker, returning true if the search has run out of time and should unwind.
+	bool visitNode(searchWorker& worker);
+
+	//	Runs on each helper thread.  Helpers search the same position as the main thread, filling the transposition table
+	//	for it, until the main thread says to stop.
+	void helperSearch(searchWorker& worker, int depthLimit);
+
+	//	Returns the value of what move captures, plus what a promotion adds.
+	int getMaterialGain(chessBoardClass& board, chessMove move);
+
+	//	Works out softLimit and hardLimit from the limits the search was given, for the side to move.
+	void setTimeLimits(const searchLimits& limits);
 
-	//	Helper function to negamax - returns a vector of actions (an actionList), sorted into descending order from their heuristic values.
-	std::stack<action*> generateActionList(gameStateNode* node);
+	//	Called on the main search thread each time an iteration finishes, with its depth, score (from the point of view of
+	//	the side to move), best move, the positions visited by all threads so far, and the milliseconds since the search
+	//	started.  Does nothing here; a front end that reports on the search overrides it.
+	virtual void reportIteration(int /*depth*/, int /*score*/, chessMove /*bestMove*/, std::uint64_t /*nodes*/, long long /*elapsed*/) { }
+
+	//	Returns the number of milliseconds since the search started.
+	long long getElapsedTime() const
+	{
+		return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - searchStart).count();
+	}
+
+	int getMax(double lhs, double rhs) { if (lhs >= rhs) return lhs; else return rhs; }
 
-	//	Helper function to negamax - takes a node, chessPiece, and action list and pushes valid actions into the passed action vector.
-	void buildActions(gameStateNode* node, chessPiece& piece, std::vector<action*>& actionList);
+	//	Helper function to negamax - records that the quiet move played at ply caused a beta cut-off.
+	void updateQuietHistory(searchWorker& worker, chessMove move, int ply, int remainingDepth);
 
-	//	Helper function to buildActions.  Takes a pointer-to-chessBoard object and pointer-to-action struct and returns a double.
+	//	Helper function to movePicker.  Takes a board and a move on it, returning the move's heuristic value and setting category
+	//	to the best quality (capture, check, etc.) the move has.
 	//	This is an implementation of the heuristic function noted above under Heuristic Function Rough Draft.
-	int evaluateHeuristic(chessBoardClass& board, action* moveData);
+	int evaluateHeuristic(chessBoardClass& board, chessMove move, action::MOVE_TYPE& category);
 
 	//	Helper function to evaluateHeuristic.  Takes a pointer-to-board and pointer-to-action struct and returns a vector containing
 	//	pieces that the piece pointed to by the action is attacking.
 	std::vector<chessPiece*> getTargets(chessBoardClass& board, action* moveData);
 
-	//	Helper function to evaluateHeuristic.  Takes a pointer-to-board and pointer-to-action struct and returns a vector containing
-	//	any pieces that are attacking the enemy king.
-	std::vector<chessPiece*> getCheckers(chessBoardClass& board, action* moveData);
-
-	//	Helper function to evaluateHeuristic.  Scans the board to see if the new move would affect the new state's defenderVector if executed.
-	//	Returns a vector of pointers-to-chessPieces that are the defenders in the new state.
-	std::vector<chessPiece*> getDefenders(chessBoardClass& board, action* moveData, std::vector<std::pair<chessPiece*, PIN_DIR>>* origDefenders);
+	//	Helper function to evaluateHeuristic.  Returns the number of pieces that would be attacking the enemy king if move were played.
+	int countCheckers(chessBoardClass& board, chessMove move);
 
-	double getNetPawnPromotion(chessBoardClass& board, action* moveData);
+	//	Helper function to evaluateHeuristic.  Returns the number of pieces that would be defending the king of the moving side if move were played.
+	int countDefenders(chessBoardClass& board, chessMove move);
 
 	//	Helper function to negamax - returns a value indicative of net change in material from currentGameState to a leaf node in the game tree.
 	//	This is an implementation of the evaluation function noted above under Evaluation Function Rough Draft.
-	//	Note:	Returns a negative value if black gains more material (or loses less) than white from currentGameState to node->gameState.
-	//			This should be taken into account when evaluating from the perspective of the min player (black).
-	int evaluatePosition(gameStateNode* node);
+	//	Note:	The value is from the point of view of the side to move, so a negative value means the side to move is behind.
+	int evaluatePosition(chessBoardClass& board);
 
 	//	By default, this will delete all of the gameStateNodes that have their markedForDelete flag set to true.  Uses post-order traversal.
 	//  If the 2nd parameter takes a true value, all gameStateNodes will be deleted (will be called in the destructor and upon game reset).
@@ -306,6 +356,9 @@ public:
 	//	Builds the game tree and returns the best move the depth of the tree allows it to determine.
 	action findBestMove(bool isMaxPlayer);
 
+	//	Searches one ply deeper at a time until the limits run out, returning the best move of the deepest iteration that finished.
+	action findBestMove(const searchLimits& limits);
+
 	//	Signals that a move (moveData) has occured, and to update the game tree accordingly.
 	void signalMove(action moveData);
 	void signalMove(const chessBoardClass& board, action moveData);
@@ -316,14 +369,36 @@ public:
 		else if (DIR == RIGHT && !currentGameState->next.empty())  currentGameState = currentGameState->next.top(); 
 	}
 
-	chessGameTree(chessBoardClass& board, int maxD = 5);
+	chessGameTree(chessBoardClass& board, int maxD = 5, int hashMB = 16);
+
+	//	Sets the size of the transposition table in megabytes, throwing away what it holds.
+	void setHashSize(int sizeMB) { table.resize(sizeMB); }
+
+	//	Sets the number of threads used by a search.
+	void setThreadCount(int count) { threadCount = std::max(count, 1); }
+
+	//	Throws away everything the transposition table holds, as if starting a new game.
+	void clearHash() { table.clear(); }
+
+	//	Asks a search running on another thread to return as soon as it has finished its first iteration.  Calling it with
+	//	false takes the request back, which has to be done before the next search if the last one ended on its own.
+	void requestStop(bool stop = true) { stopRequested = stop; }
+
+	//	Replaces the position of the current game state, for a front end that keeps track of the game itself.
+	void setGameState(const chessBoardClass& board) { currentGameState->gameState = board; }
+
+	//	Returns the number of positions the last search visited.
+	std::uint64_t getNodeCount() const { return nodeCount; }
+
+	//	Returns the depth of the deepest iteration the last search finished.
+	int getCompletedDepth() const { return completedDepth; }
 
 	chessBoardClass& getGameState() { return currentGameState->gameState; }
 
 	gameStateNode* getRootNode() { return root; }
 	gameStateNode* getCurrentNode() { return currentGameState; }
 
-	~chessGameTree();
+	virtual ~chessGameTree();
 };
 
 
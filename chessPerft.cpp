@@ -0,0 +1,315 @@
+#include "chessPerft.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+//	Counts are from the Chess Programming Wiki's perft results page, and the edge cases from the perft suite that is
+//	passed around the computer chess forums.
+const perftPosition perftPositions[] =
+{
+	{ "start position", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+		{ 1, 20, 400, 8902, 197281, 4865609, 119060324, 0 } },
+	{ "kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		{ 1, 48, 2039, 97862, 4085603, 193690690, 0, 0 } },
+	{ "position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+		{ 1, 14, 191, 2812, 43238, 674624, 11030083, 178633661 } },
+	{ "position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+		{ 1, 6, 264, 9467, 422333, 15833292, 0, 0 } },
+	{ "position 4 mirrored", "r2q1rk1/pP1p2pp/Q4n2/bbp1p3/Np6/1B3NBn/pPPP1PPP/R3K2R b KQ - 0 1",
+		{ 1, 6, 264, 9467, 422333, 15833292, 0, 0 } },
+	{ "position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+		{ 1, 44, 1486, 62379, 2103487, 89941194, 0, 0 } },
+	{ "position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+		{ 1, 46, 2079, 89890, 3894594, 164075551, 0, 0 } },
+
+	{ "illegal en passant 1", "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1",				{ 1, 0, 0, 0, 0, 0, 1440467, 0 } },
+	{ "illegal en passant 2", "8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1",				{ 1, 0, 0, 0, 0, 0, 1015133, 0 } },
+	{ "en passant gives check", "8/5bk1/8/2Pp4/8/1K6/8/8 w - d6 0 1",				{ 1, 0, 0, 0, 0, 0, 824064, 0 } },
+	{ "short castle gives check", "5k2/8/8/8/8/8/8/4K2R w K - 0 1",				{ 1, 0, 0, 0, 0, 0, 661072, 0 } },
+	{ "long castle gives check", "3k4/8/8/8/8/8/8/R3K3 w Q - 0 1",				{ 1, 0, 0, 0, 0, 0, 803711, 0 } },
+	{ "castling rights", "r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1",				{ 1, 0, 0, 0, 1274206, 0, 0, 0 } },
+	{ "castling prevented", "r3k2r/8/3Q4/8/8/5q2/8/R3K2R b KQkq - 0 1",			{ 1, 0, 0, 0, 1720476, 0, 0, 0 } },
+	{ "promote out of check", "2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1",				{ 1, 0, 0, 0, 0, 0, 3821001, 0 } },
+	{ "discovered check", "8/8/1P2K3/8/2n5/1q6/8/5k2 b - - 0 1",					{ 1, 0, 0, 0, 0, 1004658, 0, 0 } },
+	{ "promote to give check", "4k3/1P6/8/8/8/8/K7/8 w - - 0 1",					{ 1, 0, 0, 0, 0, 0, 217342, 0 } },
+	{ "underpromote to check", "8/P1k5/K7/8/8/8/8/8 w - - 0 1",					{ 1, 0, 0, 0, 0, 0, 92683, 0 } },
+	{ "self stalemate", "K1k5/8/P7/8/8/8/8/8 w - - 0 1",							{ 1, 0, 0, 0, 0, 0, 2217, 0 } },
+	{ "stalemate and checkmate 1", "8/k1P5/8/1K6/8/8/8/8 w - - 0 1",				{ 1, 0, 0, 0, 0, 0, 0, 567584 } },
+	{ "stalemate and checkmate 2", "8/8/2k5/5q2/5n2/8/5K2/8 b - - 0 1",			{ 1, 0, 0, 0, 23527, 0, 0, 0 } },
+};
+
+const int perftPositionCount = sizeof(perftPositions) / sizeof(perftPositions[0]);
+
+/*
+	================================================================
+	perftTable
+	================================================================
+*/
+
+perftTable::perftTable(int sizeMB)
+{
+	slots = NULL;
+
+	resize(sizeMB);
+}
+
+perftTable::~perftTable()
+{
+	delete[] slots;
+}
+
+void perftTable::resize(int sizeMB)
+{
+	if (sizeMB < 1)
+		sizeMB = 1;
+
+	std::uint64_t count = 1;
+	while (count * 2 * sizeof(slot) <= (std::uint64_t(sizeMB) << 20))
+		count *= 2;
+
+	delete[] slots;
+	slots = new slot[count];
+	slotMask = count - 1;
+
+	clear();
+}
+
+void perftTable::clear()
+{
+	for (std::uint64_t i = 0; i <= slotMask; ++i)
+	{
+		slots[i].check.store(0, std::memory_order_relaxed);
+		slots[i].data.store(0, std::memory_order_relaxed);
+	}
+}
+
+bool perftTable::probe(positionKey key, int depth, std::uint64_t& nodes)
+{
+	slot& s = slots[key & slotMask];
+
+	std::uint64_t data = s.data.load(std::memory_order_relaxed);
+	std::uint64_t check = s.check.load(std::memory_order_relaxed);
+
+	if (data == 0 || (check ^ data) != key || int(data >> 56) != depth)
+		return false;
+
+	nodes = data & 0x00FFFFFFFFFFFFFFull;
+	return true;
+}
+
+void perftTable::store(positionKey key, int depth, std::uint64_t nodes)
+{
+	slot& s = slots[key & slotMask];
+
+	std::uint64_t data = (std::uint64_t(depth) << 56) | (nodes & 0x00FFFFFFFFFFFFFFull);
+
+	s.data.store(data, std::memory_order_relaxed);
+	s.check.store(key ^ data, std::memory_order_relaxed);
+}
+
+/*
+	================================================================
+	Perft
+	================================================================
+*/
+
+std::uint64_t perft(chessBoardClass& board, int depth, perftTable* table)
+{
+	if (depth == 0)
+		return 1;
+
+	moveList moves;
+	board.generateMoves(moves);
+
+	//	Bulk counting:  every legal move at the last ply is one leaf.
+	if (depth == 1)
+		return moves.size();
+
+	std::uint64_t nodes = 0;
+	positionKey key = board.getZobristKey();
+
+	if (table != NULL && table->probe(key, depth, nodes))
+		return nodes;
+
+	for (int i = 0; i < moves.size(); ++i)
+	{
+		undoInfo undo;
+		board.makeMove(moves[i], undo);
+		nodes += perft(board, depth - 1, table);
+		board.unmakeMove(undo);
+	}
+
+	if (table != NULL)
+		table->store(key, depth, nodes);
+
+	return nodes;
+}
+
+//	A piece of a split perft:  the subtree under a root move, or under a root move and one reply.
+struct perftTask
+{
+	int rootIndex;			// Index of the root move in the root moveList.
+	chessMove reply;		// Reply to the root move, or an empty chessMove if the task is the whole root move.
+	std::uint64_t nodes;
+};
+
+//	Run by each thread of a split perft:  claims tasks by index until none are left.
+static void perftWorker(const chessBoardClass* start, moveList* rootMoves, int depth, std::vector<perftTask>* tasks,
+	std::atomic<int>* nextTask, perftTable* table)
+{
+	chessBoardClass board;
+	board.init();
+	board = *start;
+
+	for (int i = nextTask->fetch_add(1); i < int(tasks->size()); i = nextTask->fetch_add(1))
+	{
+		perftTask& task = (*tasks)[i];
+
+		undoInfo rootUndo, replyUndo;
+		board.makeMove((*rootMoves)[task.rootIndex], rootUndo);
+
+		if (task.reply == chessMove())
+			task.nodes = perft(board, depth - 1, table);
+		else
+		{
+			board.makeMove(task.reply, replyUndo);
+			task.nodes = perft(board, depth - 2, table);
+			board.unmakeMove(replyUndo);
+		}
+
+		board.unmakeMove(rootUndo);
+	}
+}
+
+//	Fills counts with the number of nodes under each move of moves, the legal moves of board, using threadCount threads.
+static void countRootMoves(chessBoardClass& board, int depth, int threadCount, perftTable* table, moveList& moves,
+	std::vector<std::uint64_t>& counts)
+{
+	board.generateMoves(moves);
+	counts.assign(moves.size(), 0);
+
+	if (depth < 1)
+		return;
+
+	//	Cut at ply 2 if there are too few root moves to go around.  A root move with no replies still needs a task,
+	//	which then counts as 0.
+	bool splitReplies = (depth >= 3 && moves.size() < 4 * threadCount);
+	std::vector<perftTask> tasks;
+
+	for (int i = 0; i < moves.size(); ++i)
+	{
+		moveList replies;
+
+		if (splitReplies)
+		{
+			undoInfo undo;
+			board.makeMove(moves[i], undo);
+			board.generateMoves(replies);
+			board.unmakeMove(undo);
+		}
+
+		if (replies.empty())
+			tasks.push_back({ i, chessMove(), 0 });
+
+		for (int j = 0; j < replies.size(); ++j)
+			tasks.push_back({ i, replies[j], 0 });
+	}
+
+	std::atomic<int> nextTask(0);
+
+	if (threadCount <= 1)
+		perftWorker(&board, &moves, depth, &tasks, &nextTask, table);
+	else
+	{
+		std::vector<std::thread> threads;
+		for (int i = 0; i < threadCount; ++i)
+			threads.push_back(std::thread(perftWorker, &board, &moves, depth, &tasks, &nextTask, table));
+
+		for (int i = 0; i < threadCount; ++i)
+			threads[i].join();
+	}
+
+	for (int i = 0; i < int(tasks.size()); ++i)
+		counts[tasks[i].rootIndex] += tasks[i].nodes;
+}
+
+std::uint64_t perftParallel(chessBoardClass& board, int depth, int threadCount, perftTable* table)
+{
+	if (depth < 2 || threadCount <= 1)
+		return perft(board, depth, table);
+
+	moveList moves;
+	std::vector<std::uint64_t> counts;
+	countRootMoves(board, depth, threadCount, table, moves, counts);
+
+	std::uint64_t total = 0;
+	for (int i = 0; i < moves.size(); ++i)
+		total += counts[i];
+
+	return total;
+}
+
+std::uint64_t perftDivide(chessBoardClass& board, int depth, std::ostream& out, perftTable* table, int threadCount)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	moveList moves;
+	std::vector<std::uint64_t> counts;
+	countRootMoves(board, depth, threadCount, table, moves, counts);
+
+	std::uint64_t total = 0;
+
+	for (int i = 0; i < moves.size(); ++i)
+	{
+		out << moves[i].toString() << ": " << counts[i] << "\n";
+		total += counts[i];
+	}
+
+	long long elapsed = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+	out << "\nNodes searched: " << total << "\n";
+	out << "Time: " << elapsed << " ms, " << (elapsed > 0 ? total * 1000 / elapsed : total) << " nodes per second" << std::endl;
+
+	return total;
+}
+
+bool perftSuite(int maxDepth, std::ostream& out, perftTable* table, int threadCount)
+{
+	chessBoardClass board;
+	board.init();
+
+	bool passed = true;
+	std::uint64_t totalNodes = 0;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < perftPositionCount; ++i)
+	{
+		const perftPosition& position = perftPositions[i];
+
+		int depth = (maxDepth < 7) ? maxDepth : 7;
+		while (depth > 0 && position.nodes[depth] == 0)
+			--depth;
+
+		if (depth == 0 || !board.loadFEN(position.fen))
+		{
+			out << position.name << ":  skipped" << std::endl;
+			continue;
+		}
+
+		std::uint64_t nodes = perftParallel(board, depth, threadCount, table);
+		bool match = (nodes == position.nodes[depth]);
+
+		out << position.name << ", depth " << depth << ":  " << nodes << (match ? "  ok" : "  FAILED, expected ")
+			<< (match ? "" : std::to_string(position.nodes[depth])) << std::endl;
+
+		passed = passed && match;
+		totalNodes += nodes;
+	}
+
+	long long elapsed = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+	out << (passed ? "All positions passed" : "Some positions FAILED") << ", " << totalNodes << " nodes in " << elapsed
+		<< " ms, " << (elapsed > 0 ? totalNodes * 1000 / elapsed : totalNodes) << " nodes per second" << std::endl;
+
+	return passed;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#ifndef CHESS_PERFT_
+#define CHESS_PERFT_
+
+#include "chessBoardClass.h"
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+//	====== Perft Notes ======
+/*
+	Perft (performance test) counts the leaf nodes of the legal move tree of a position to a fixed depth.  The counts
+	for a set of well-known positions have been worked out by many engines, so comparing against them is the standard
+	way to find move generation bugs.  Castling, en passant, promotion, and pins each have positions that single them
+	out.  Because perft does nothing but generate, make, and unmake moves, its speed is also a direct measure of
+	move generation speed.
+
+	Two things make it faster without changing the count.  At the last ply the moves are only counted, not made
+	(bulk counting).  And a position reached again by a different move order to the same remaining depth has the same
+	count, so a perftTable can remember counts by Zobrist key and depth.  The table works like the transposition table
+	(see chessTranspositionTable.h):  each slot is a key check and a data word, and takes no locks.
+
+	Divide prints the count under each root move, which is how a wrong total is narrowed down to the move it comes
+	from:  compare against another engine's divide, play the move that differs, and divide again.
+
+	Deep perfts are split over several threads.  The tree is cut at the root into one task per legal move, or, if
+	there are too few root moves to keep every thread busy, into one task per pair of moves (ply 2).  Each thread has
+	its own copy of the board and takes the next unclaimed task until there are none left, so a thread that finishes
+	a small subtree early moves straight on to more work.  Every task's count is kept in its own slot and the slots
+	are added up in move order once the threads are done, so the totals and the divide output are the same for any
+	number of threads.  The threads can share one perftTable.
+*/
+
+//	A reference position and its known node counts.  nodes[d] is the count at depth d, or 0 if it isn't listed.
+struct perftPosition
+{
+	const char* name;
+	const char* fen;
+	std::uint64_t nodes[8];
+};
+
+extern const perftPosition perftPositions[];
+extern const int perftPositionCount;
+
+//	Counts remembered by position and depth.
+class perftTable
+{
+protected:
+	//	data layout:  bits 0-55 count, 56-63 depth.  A depth is never 0, so data is never 0 for a stored count.
+	struct slot
+	{
+		std::atomic<std::uint64_t> check;
+		std::atomic<std::uint64_t> data;
+	};
+
+	slot* slots;
+	std::uint64_t slotMask;		// Number of slots - 1.
+
+public:
+	//	sizeMB is the most memory the table may use, in megabytes.
+	perftTable(int sizeMB = 16);
+	~perftTable();
+
+	//	Throws away every count and sizes the table to the largest power-of-two number of slots that fits in sizeMB.
+	void resize(int sizeMB);
+
+	//	Throws away every count.
+	void clear();
+
+	//	Looks up the count for key to depth, filling in nodes and returning true if it is in the table.
+	bool probe(positionKey key, int depth, std::uint64_t& nodes);
+
+	//	Stores the count for key to depth, replacing whatever was in its slot.
+	void store(positionKey key, int depth, std::uint64_t nodes);
+
+	perftTable(const perftTable&) = delete;
+	void operator=(const perftTable&) = delete;
+};
+
+//	Returns the number of leaf nodes of the legal move tree of board to depth.  table may be NULL.
+std::uint64_t perft(chessBoardClass& board, int depth, perftTable* table = NULL);
+
+//	perft() split over threadCount threads.
+std::uint64_t perftParallel(chessBoardClass& board, int depth, int threadCount, perftTable* table = NULL);
+
+//	Writes the count under each legal move of board, then the total, the time taken, and the nodes per second, to out.
+//	Returns the total.
+std::uint64_t perftDivide(chessBoardClass& board, int depth, std::ostream& out, perftTable* table = NULL, int threadCount = 1);
+
+//	Runs every reference position, each to the deepest listed depth no greater than maxDepth, writing a line per
+//	position to out.  Returns true if every count matched.
+bool perftSuite(int maxDepth, std::ostream& out, perftTable* table = NULL, int threadCount = 1);
+
+#endif
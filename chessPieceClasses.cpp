@@ -33,26 +33,9 @@
 //	Pawn movement properties:
 /*
 	Can move forward 1 space.
-	Can move forward 2 spaces if row == 6 (Black pawn starting position - where row count starts at 0).
+	Can move forward 2 spaces from its starting row (row 1 for white, row 6 for black - where row count starts at 0).
 	Can move diagonally up-left or up-right a city-block distance of 2.
 */
-bool blackPawn::validMovement(int c, int r)
-{
-	// Check to make sure movement is within bounds
-	if (!inBounds(c, r))
-		return false;
-	if (!isMove(c, r))
-		return false;
-
-	if (column == c && row == 6 && r == 4)		// Forward 2 from starting position case.
-		return true;
-	else if (column == c && (row - r) == 1)		// Forward 1 case
-		return true;
-	else if (((row - r) == 1) && (std::abs(column - c) == 1))	// Diagonal movement case.
-		return true;
-	else
-		return false;
-}
 //	Remaining movement checks to be performed by chessBoard class:
 /*
 	-	Friendly fire
@@ -109,17 +92,6 @@ bool blackPawn::validMovement(int c, int r)
 	So long as ((std::abs(column - c) + std::abs(row - r) == 3) && r != row && c != column)
 	is true, then the knight's movement is valid.
 */
-bool blackKnight::validMovement(int c, int r)
-{
-	using std::abs;
-
-	if (!inBounds(c, r))
-		return false;
-	if (!isMove(c, r))
-		return false;
-
-	return (((abs(column - c) + abs(row - r)) == 3) && r != row && c != column);
-}
 //	Remaining movement checks to be performed by chessBoard class:
 /*
 	-	Friendly fire
@@ -145,17 +117,6 @@ bool blackKnight::validMovement(int c, int r)
 	This ensures that diagonal movements are only valid if the slope is strictly +/- 1, and
 	it rules out bishops being able to move horizontally or vertically.
 */
-bool blackBishop::validMovement(int c, int r)
-{
-	using std::abs;
-
-	if (!inBounds(c, r))
-		return false;
-	if (!isMove(c, r))
-		return false;
-
-	return (abs(r - row) == abs(c - column));
-}
 //	Remaining movement checks to be performed by chessBoard class:
 /*
 	-	Friendly fire
@@ -183,15 +144,6 @@ bool blackBishop::validMovement(int c, int r)
 	a change in both column AND row values, and either case requires some constancy in
 	either the column or the row.
 */
-bool blackRook::validMovement(int c, int r)
-{
-	if (!inBounds(c, r))
-		return false;
-	if (!isMove(c, r))
-		return false;
-
-	return ((c == column && r != row) || (r == row && c != column));
-}
 //	Remaining movement checks to be performed by chessBoard class:
 /*
 -	Friendly fire
@@ -213,16 +165,6 @@ bool blackRook::validMovement(int c, int r)
 
 	(abs(r - row) == abs(c - column)) || ((c == column && r != row) || (r == row && c != column));
 */
-bool blackQueen::validMovement(int c, int r)
-{
-	if (!inBounds(c, r))
-		return false;
-	if (!isMove(c, r))
-		return false;
-
-	//			(Bishop movement test)		 ||					  (Rook movement test)
-	return (abs(r - row) == abs(c - column)) || ((c == column && r != row) || (r == row && c != column));
-}
 //	Remaining movement checks to be performed by chessBoard class:
 /*
 	-	Friendly fire
@@ -268,30 +210,6 @@ bool blackQueen::validMovement(int c, int r)
 
 	Note:  This method only checks the 1st case.
 */
-bool blackKing::validMovement(int c, int r)
-{
-	using std::abs;
-
-	if (!inBounds(c, r))
-		return false;
-	if (!isMove(c, r))
-		return false;
-
-	// Castling Movement
-	if (abs(c - column) == 2 && r == row && row == 7)
-	{
-		if (canCastle)
-			return true;
-		else
-			return false;
-	}
-		
-	// Regular movement
-	if (r == row || c == column)
-		return (abs(r - row) + abs(c - column) == 1);
-	else
-		return (abs(r - row) + abs(c - column) == 2);
-}
 //	Remaining movement checks to be performed by chessBoard class:
 /*
 	-	Friendly fire
@@ -301,99 +219,29 @@ bool blackKing::validMovement(int c, int r)
 */
 
 
-// The following validMovement definitions are all the same as above, but defined for white pieces.
-
-
-bool whitePawn::validMovement(int c, int r)
-{
-	// Check to make sure movement is within bounds
-	if (!inBounds(c, r))
-		return false;
-	if (!isMove(c, r))
-		return false;
-
-	// Note: Pawn movement direction has changed from the blackPawn definition above.
-
-	if (column == c && row == 1 && r == 3)		// Forward 2 from starting position case.
-		return true;
-	else if (column == c && (r - row) == 1)		// Forward 1 case
-		return true;
-	else if (((r - row) == 1) && (std::abs(column - c) == 1))	// Diagonal movement case.
-		return true;
-	else
-		return false;
-}
-
-
-bool whiteKnight::validMovement(int c, int r)
-{
-	using std::abs;
-
-	if (!inBounds(c, r))
-		return false;
-	if (!isMove(c, r))
-		return false;
-
-	return (((abs(column - c) + abs(row - r)) == 3) && r != row && c != column);
-}
-
-
-bool whiteBishop::validMovement(int c, int r)
+//	Picks the movement rule for the piece's type and color.  Code that knows the piece's class calls
+//	chessPieceOf::validMovement() instead, which skips this switch.
+bool chessPiece::validMovement(int c, int r) const
 {
-	using std::abs;
-
-	if (!inBounds(c, r))
-		return false;
-	if (!isMove(c, r))
-		return false;
-
-	return (abs(r - row) == abs(c - column));
-}
-
-
-bool whiteRook::validMovement(int c, int r)
-{
-	if (!inBounds(c, r))
-		return false;
-	if (!isMove(c, r))
-		return false;
-
-	return ((c == column && r != row) || (r == row && c != column));
-}
-
-
-bool whiteQueen::validMovement(int c, int r)
-{
-	if (!inBounds(c, r))
-		return false;
-	if (!isMove(c, r))
-		return false;
-
-	//			(Bishop movement test)		 ||					  (Rook movement test)
-	return (abs(r - row) == abs(c - column)) || ((c == column && r != row) || (r == row && c != column));
-}
-
-
-bool whiteKing::validMovement(int c, int r)
-{
-	using std::abs;
-
-	if (!inBounds(c, r))
-		return false;
-	if (!isMove(c, r))
-		return false;
-
-	// Castling Movement
-	if (abs(c - column) == 2 && r == row && row == 0)
+	switch (type)
 	{
-		if (canCastle)
-			return true;
+	case PAWN:
+		if (color == WHITE)
+			return movementRule<WHITE, PAWN>::valid(column, row, c, r, moveFlag);
 		else
-			return false;
+			return movementRule<BLACK, PAWN>::valid(column, row, c, r, moveFlag);
+	case KNIGHT:
+		return movementRule<WHITE, KNIGHT>::valid(column, row, c, r, moveFlag);
+	case BISHOP:
+		return movementRule<WHITE, BISHOP>::valid(column, row, c, r, moveFlag);
+	case ROOK:
+		return movementRule<WHITE, ROOK>::valid(column, row, c, r, moveFlag);
+	case QUEEN:
+		return movementRule<WHITE, QUEEN>::valid(column, row, c, r, moveFlag);
+	default:	// KING
+		if (color == WHITE)
+			return movementRule<WHITE, KING>::valid(column, row, c, r, moveFlag);
+		else
+			return movementRule<BLACK, KING>::valid(column, row, c, r, moveFlag);
 	}
-
-	if (r == row || c == column)
-		return (abs(r - row) + abs(c - column) == 1);
-	else
-		return (abs(r - row) + abs(c - column) == 2);
-}
\ No newline at end of file
+}
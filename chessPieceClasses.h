@@ -4,6 +4,9 @@
 #define CHESS_PIECE_CLASSES
 
 #include <string>
+#include <cstdlib>
+
+#include "chessBitboard.h"
 
 
 
@@ -12,315 +15,221 @@
 	This is a redesign for the chess/chessboard interface.  This will hopefully 
 	make it more programmer friendly as the initial version is difficult to read and reason about.
 
-	The abstract base class shows the general properties and interface that is common to all
-	chess pieces, regardless of type or color.  The following class definitions get less and less
-	general, until the end result is separate classes for each color/type of chess piece.
-
-	It should be noted that the only difference between a blackPawn and a whitePawn (or classes pertaining
-	to another type and their color counterpart) is that the std::string color variable is set to the
-	appropriate value upon construction.  The classes themselves are in all other respects defined the same.
-	This is mainly done so the code is more self-documenting.
+	chessPiece holds everything a piece knows about itself:  where it is, its color and type, whether it has been
+	captured, and its one movement flag (canCastle for rooks and kings, enPassant for pawns).  None of its methods
+	are virtual, so reading a piece through a chessPiece pointer costs no more than reading a struct.
 
-	1st Level:  Chess Piece
-	2nd Level:  <Color> Chess Piece (<Color> == (Black || White))
-	3rd Level:  <Color> <Type> (<Type> == (Pawn || Knight || Bishop || Rook || Queen || King))
+	Each color and type of piece is the class template chessPieceOf<Color, Type>, named by the typedefs at the bottom
+	(blackPawn, whiteKnight, and so on).  The movement rules of each type are the movementRule templates below.  Code
+	that knows the piece's class at compile time, such as the chessBoardClass code that works on one piece pool,
+	gets the rules for that color and type inlined.  Code that only has a chessPiece pointer goes through
+	chessPiece::validMovement(), which picks the rule by type.
 
-	The third level classes will be instance variables of chessBoardClass:
+	The pieces are instance variables of chessBoardClass, kept in one fixed-size pool per color and type
+	(see chessPiecePool.h):
 
-	vector<blackPawn*> bPawnVector();
-	vector<blackKnight*> bKnightVector();
-	vector<blackBishop*> bBishopVector();
-	vector<blackRook*> bRookVector();
-	vector<blackQueen*> bQueenVector();
-	vector<blackKing*> bKing();
-	(etc., for white pieces)
+	piecePool<blackPawn, 8> bPawns;
+	piecePool<blackKnight, 10> bKnights;
+	(etc., for every type and for white pieces)
 
-	Pieces will be handled with pointers stored in vectors for easy deletion upon capture.
-	Vectors and pointers also allow for major pieces to be easily added upon pawn promotions.
-	The pointer to king is kept in a vector for the sake of consistency.
+	Pieces stay in their pool when captured, with their captured flag set, and promoted pieces are added to the end
+	of the pool of their new type.
 */
 
 enum PIECE_COLOR { WHITE, BLACK };
 enum PIECE_TYPE { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING };
 
 
-// Abstract base class - establishes interface common to all derived classes of chessPiece
-class chessPiece
-{
-protected:
-	int column;			// Note:  column count starts at 0 (chess board is represented w/ a 2d array)
-	int row;			// Note:  row count starts at 0 (chess board is represented w/ a 2d array).
-	enum PIECE_COLOR color;
-	enum PIECE_TYPE type;
-	bool captured;
-
-	virtual void setColumn(int c) = 0;
-	virtual void setRow(int r) = 0;
-	bool inBounds(int c, int r) { return !(c > 7 || c < 0 || r > 7 || r < 0); } // Pieces must stay on the board
-	bool isMove(int c, int r) { return !(c == column && r == row); }			// New square cannot be the old square 
-
-	/* Both inBounds() and isMove() are basic checks that every validMovement() method of each type must perform */
-
-public:
-	virtual int getColumn() = 0;
-	virtual int getRow() = 0;
-	virtual PIECE_COLOR getColor() = 0;
-	virtual PIECE_TYPE getType() = 0;
-	virtual bool validMovement(int c, int r) = 0;	// Must be defined per type.  See note below.
-	virtual void moveTo(int c, int r) = 0;			// If move is completely valid, then moveTo may be called.
-	virtual void setCaptured(bool flag) = 0;
-	virtual bool getCaptured() const = 0;
-	chessPiece(const chessPiece& piece) { column = piece.column; row = piece.row; color = piece.color; type = piece.type; captured = piece.captured; }
-	chessPiece() { }
-	bool operator==(const chessPiece& piece) { return (column == piece.column && row == piece.row && color == piece.color && type == piece.type && captured == piece.captured); }
-};
-
 //	====================================
-//	Notes on validMovement(int c, int r)		[ c and r represent target column and row, respectively ]
+//	Movement rules						[ (column, row) is where the piece is, (c, r) where it is asked to go ]
 //	====================================
-/*	
-	This is not a "solve-all" test to determine if the final move should be carried out.
-	This only determines if the movement of any calling chess piece follows the 
-	most fundamental rules of the piece itself.
-
-	For instance, if called on a pawn object, it will only check if the pawn would be moving
-	forward 1, diagonally up-left/up-right, or forward 2 if the pawn is in the starting position.
-
-	The function will not determine if the pawn's movement would be blocked by another
-	piece, or if there is a piece to capture in the event of diagonal movement, or if the piece is pinned.
-
-	This is essentially a "first-wave" check on attempted movement to determine if, as stated,
-	the movement follows the most fundamental rules of piece movement.  For example, it will
-	rule out ridiculous moves, like trying to move a king 3 forward and 1 right, or moving pieces
-	out of bounds (pawn to x57 is not a valid move).
-
-	Other movement checks, e.g., ensuring a king isn't moved into check, making sure pieces can't
-	"phase through" each other (aside from the knight), ensuring there is no "friendly fire," etc.,
-	will be performed by the chessBoard class.  This is necessary since information about the current
-	state of the board is not handled by chessType classes, and is private to the chessBoard class.
+/*
+	Each rule only checks that a move follows the most fundamental rules of the piece itself; see the notes on
+	validMovement() in chessPieceClasses.cpp.  Every rule starts with the checks all pieces share:  the piece must
+	stay on the board, and must actually move.
 */
 
-class blackChessPiece : public chessPiece
+inline bool pieceMoveInBounds(int column, int row, int c, int r)
 {
-protected:
-	void setColumn(int c) { column = c; }
-	void setRow(int r) { row = r; }
+	return !(c > 7 || c < 0 || r > 7 || r < 0) && !(c == column && r == row);
+}
 
-public:
-	int getColumn() { return column; }
-	int getRow() { return row; }
-	bool getCaptured() const { return captured; }
-	void setCaptured(bool flag) { captured = flag; }
-	blackChessPiece(const blackChessPiece& piece) { column = piece.column; row = piece.row; color = piece.color; type = piece.type; captured = piece.captured; }
-	blackChessPiece() { }
+template <PIECE_COLOR color, PIECE_TYPE type>
+struct movementRule;
 
-	PIECE_COLOR getColor() { return color; }
+//	Forward 1, forward 2 from the starting row, or diagonally forward 1 (to capture).  White moves up the rows,
+//	black down.
+template <PIECE_COLOR color>
+struct movementRule<color, PAWN>
+{
+	static bool valid(int column, int row, int c, int r, bool)
+	{
+		const int forward = (color == WHITE) ? 1 : -1;
+		const int startRow = (color == WHITE) ? 1 : 6;
+
+		if (!pieceMoveInBounds(column, row, c, r))
+			return false;
+
+		if (column == c && row == startRow && r == startRow + 2 * forward)		// Forward 2 from starting position case.
+			return true;
+		else if (column == c && (r - row) == forward)							// Forward 1 case
+			return true;
+		else																	// Diagonal movement case.
+			return (pawnAttacks(color, squareIndex(column, row)) & squareBit(c, r)) != 0;
+	}
 };
 
-class whiteChessPiece : public chessPiece
+//	Any move with a city-block distance of 3 that is neither purely horizontal nor vertical.
+template <PIECE_COLOR color>
+struct movementRule<color, KNIGHT>
 {
-protected:
-	void setColumn(int c) { column = c; }
-	void setRow(int r) { row = r; }
-public:
-	int getColumn() { return column; }
-	int getRow() { return row; }
-	bool getCaptured() const { return captured; }
-	void setCaptured(bool flag) { captured = flag; }
-	whiteChessPiece(const whiteChessPiece& piece) { column = piece.column; row = piece.row; color = piece.color; type = piece.type; captured = piece.captured; }
-	whiteChessPiece() { }
-	
-	PIECE_COLOR getColor() { return color; }
+	static bool valid(int column, int row, int c, int r, bool)
+	{
+		return pieceMoveInBounds(column, row, c, r) && (knightAttacks(squareIndex(column, row)) & squareBit(c, r)) != 0;
+	}
 };
 
-
-class blackPawn : public blackChessPiece
+//	Diagonal lines:  the row and column change by the same amount.
+template <PIECE_COLOR color>
+struct movementRule<color, BISHOP>
 {
-private:
-	bool enPassant;
-public: 
-	blackPawn(int c, int r) : enPassant(false)
-	{ setColumn(c); setRow(r); color = BLACK; type = PAWN; setCaptured(false); }
-
-	PIECE_TYPE getType() { return type; }
-	bool validMovement(int c, int r);
-	void moveTo(int c, int r) { if (abs(getRow() - r) == 2) setEnPassant(true); setColumn(c); setRow(r); }
-	void setEnPassant(bool flag) { enPassant = flag; }
-	bool getEnPassant() { return enPassant; }
-	blackPawn() { }
+	static bool valid(int column, int row, int c, int r, bool)
+	{
+		return pieceMoveInBounds(column, row, c, r) && std::abs(r - row) == std::abs(c - column);
+	}
 };
 
-
-class blackKnight : public blackChessPiece
-{ 
-public: 
-	blackKnight(int c, int r) 
-	{ setColumn(c); setRow(r); color = BLACK; type = KNIGHT; setCaptured(false); }
-
-	PIECE_TYPE getType() { return type; }
-	bool validMovement(int c, int r);
-	void moveTo(int c, int r) { setColumn(c); setRow(r); }
-	blackKnight() { }
+//	Straight lines:  either the row or the column stays the same.
+template <PIECE_COLOR color>
+struct movementRule<color, ROOK>
+{
+	static bool valid(int column, int row, int c, int r, bool)
+	{
+		return pieceMoveInBounds(column, row, c, r) && (c == column || r == row);
+	}
 };
 
-
-class blackBishop : public blackChessPiece
+//	Either a bishop's move or a rook's move.
+template <PIECE_COLOR color>
+struct movementRule<color, QUEEN>
 {
-public:
-	blackBishop(int c, int r)
-	{ setColumn(c); setRow(r); color = BLACK; type = BISHOP; setCaptured(false); }
-
-	PIECE_TYPE getType() { return type; }
-	bool validMovement(int c, int r);
-	void moveTo(int c, int r) { setColumn(c); setRow(r); }
-	blackBishop() { }
+	static bool valid(int column, int row, int c, int r, bool canCastle)
+	{
+		return movementRule<color, BISHOP>::valid(column, row, c, r, canCastle) || movementRule<color, ROOK>::valid(column, row, c, r, canCastle);
+	}
 };
 
-
-class blackRook : public blackChessPiece
+//	One square in any direction, or two squares sideways along the home row to castle, if the king hasn't moved.
+template <PIECE_COLOR color>
+struct movementRule<color, KING>
 {
-private:
-	bool canCastle;
-public:
-	blackRook(int c, int r) : canCastle(true) 
-	{ setColumn(c); setRow(r); color = BLACK; type = ROOK; setCaptured(false); }
-
-	PIECE_TYPE getType() { return type; }
-	bool validMovement(int c, int r);
-	void moveTo(int c, int r) { setColumn(c); setRow(r); setCastle(false); }
-	void setCastle(bool flag) { canCastle = flag; }
-	bool getCastle() { return canCastle; }
-	blackRook() { } 
-};
+	static bool valid(int column, int row, int c, int r, bool canCastle)
+	{
+		const int homeRow = (color == WHITE) ? 0 : 7;
 
+		if (!pieceMoveInBounds(column, row, c, r))
+			return false;
 
-class blackQueen : public blackChessPiece
-{
-public:
-	blackQueen(int c, int r) 
-	{ setColumn(c); setRow(r); color = BLACK; type = QUEEN; setCaptured(false); }
+		// Castling Movement
+		if (std::abs(c - column) == 2 && r == row && row == homeRow)
+			return canCastle;
 
-	PIECE_TYPE getType() { return type; }
-	bool validMovement(int c, int r);
-	void moveTo(int c, int r) { setColumn(c); setRow(r); }
-	blackQueen() { }
+		return (kingAttacks(squareIndex(column, row)) & squareBit(c, r)) != 0;
+	}
 };
 
 
-class blackKing : public blackChessPiece
+//	Base class - the state and interface common to every piece, regardless of type or color.
+class chessPiece
 {
-private:
-	bool canCastle;
-public:
-	blackKing(int c, int r) : canCastle(true)
-	{ setColumn(c); setRow(r); color = BLACK; type = KING; setCaptured(false); }
-
-	PIECE_TYPE getType() { return type; }
-	bool validMovement(int c, int r);
-	void moveTo(int c, int r) { setColumn(c); setRow(r); canCastle = false; }
-	bool getCastle() { return canCastle; }
-	blackKing() { }
-};
+protected:
+	int column;			// Note:  column count starts at 0 (chess board is represented w/ a 2d array)
+	int row;			// Note:  row count starts at 0 (chess board is represented w/ a 2d array).
+	enum PIECE_COLOR color;
+	enum PIECE_TYPE type;
+	bool captured;
+	bool moveFlag;		// canCastle for rooks and kings, enPassant for pawns.  Unused by other pieces.
 
-/*
-	Below are the classes for the white variants of the above black<Type> classes.
-	They are essentially identical, with the only difference being the std::string color
-	value of each class is set to it's appropriate value ("white").  In every other respect,
-	each class below behaves identically to its color counterpart.
+	void setColumn(int c) { column = c; }
+	void setRow(int r) { row = r; }
 
-	Note:	White pawn movement is changed to account for opposite movement direction.
-*/
+	//	The one implementation of moveTo(), for a piece of type pieceType.  A pawn that moves two rows can be taken
+	//	en passant, and a rook or king that moves can no longer castle.
+	void moveAs(PIECE_TYPE pieceType, int c, int r)
+	{
+		if (pieceType == PAWN && std::abs(row - r) == 2)
+			moveFlag = true;
+		else if (pieceType == ROOK || pieceType == KING)
+			moveFlag = false;
+
+		column = c;
+		row = r;
+	}
 
-class whitePawn : public whiteChessPiece
-{
-private:
-	bool enPassant;
 public:
-	whitePawn(int c, int r) : enPassant(false) 
-	{ setColumn(c); setRow(r); color = WHITE; type = PAWN; setCaptured(false); }
+	int getColumn() const { return column; }
+	int getRow() const { return row; }
+	PIECE_COLOR getColor() const { return color; }
+	PIECE_TYPE getType() const { return type; }
+	bool getCaptured() const { return captured; }
+	void setCaptured(bool flag) { captured = flag; }
 
-	whitePawn() { enPassant = false; color = WHITE; type = PAWN; }
+	//	The canCastle or enPassant flag, whichever the piece has.
+	bool getMoveFlag() const { return moveFlag; }
+	void setMoveFlag(bool flag) { moveFlag = flag; }
 
-	whitePawn(const whitePawn& obj) { this->setColumn(obj.column); setRow(obj.row); color = WHITE; type = PAWN; setCaptured(obj.captured); setEnPassant(obj.enPassant); }
+	//	Checks the move against the rules for the piece's type (see movementRule).
+	bool validMovement(int c, int r) const;
 
-	PIECE_TYPE getType() { return type; }
-	bool validMovement(int c, int r);
-	void moveTo(int c, int r) { if (abs(getRow() - r) == 2) setEnPassant(true); setColumn(c); setRow(r); }
-	void setEnPassant(bool flag) { enPassant = flag; }
-	bool getEnPassant() { return enPassant; }
+	//	If move is completely valid, then moveTo may be called.  See moveAs().
+	void moveTo(int c, int r) { moveAs(type, c, r); }
 
+	bool operator==(const chessPiece& piece) { return (column == piece.column && row == piece.row && color == piece.color && type == piece.type && captured == piece.captured); }
 };
 
 
-class whiteKnight : public whiteChessPiece
+//	A piece of one color and type.  The type and color are constants, so calls made on a piece of a known class
+//	are resolved (and inlined) at compile time.
+template <PIECE_COLOR pieceColor, PIECE_TYPE pieceType>
+class chessPieceOf : public chessPiece
 {
 public:
-	whiteKnight(int c, int r) 
-	{ setColumn(c); setRow(r); color = WHITE; type = KNIGHT; setCaptured(false); }
+	chessPieceOf(int c, int r)
+	{
+		column = c; row = r; color = pieceColor; type = pieceType; captured = false;
+		moveFlag = (pieceType == ROOK || pieceType == KING);
+	}
 
-	PIECE_TYPE getType() { return type; }
-	bool validMovement(int c, int r);
-	void moveTo(int c, int r) { setColumn(c); setRow(r); }
-	whiteKnight() { }
-};
+	chessPieceOf() { column = 0; row = 0; color = pieceColor; type = pieceType; captured = false; moveFlag = (pieceType == ROOK || pieceType == KING); }
 
+	PIECE_COLOR getColor() const { return pieceColor; }
+	PIECE_TYPE getType() const { return pieceType; }
 
-class whiteBishop : public whiteChessPiece
-{
-public:
-	whiteBishop(int c, int r) 
-	{ setColumn(c); setRow(r); color = WHITE; type = BISHOP; setCaptured(false); }
+	bool validMovement(int c, int r) const { return movementRule<pieceColor, pieceType>::valid(column, row, c, r, moveFlag); }
 
-	PIECE_TYPE getType() { return type; }
-	bool validMovement(int c, int r);
-	void moveTo(int c, int r) { setColumn(c); setRow(r); }
-	whiteBishop() { }
-};
+	//	The type is a constant here, so the flag update folds down to the one case that applies.
+	void moveTo(int c, int r) { moveAs(pieceType, c, r); }
 
+	void setEnPassant(bool flag) { static_assert(pieceType == PAWN, "only pawns can be taken en passant"); moveFlag = flag; }
+	bool getEnPassant() const { static_assert(pieceType == PAWN, "only pawns can be taken en passant"); return moveFlag; }
 
-class whiteRook : public whiteChessPiece
-{
-private:
-	bool canCastle;
-public:
-	whiteRook(int c, int r) : canCastle(true)
-	{ setColumn(c); setRow(r); color = WHITE; type = ROOK; setCaptured(false); }
-
-	PIECE_TYPE getType() { return type; }
-	bool validMovement(int c, int r);
-	void moveTo(int c, int r) { setColumn(c); setRow(r); setCastle(false); }
-	void setCastle(bool flag) { canCastle = flag; }
-	bool getCastle() { return canCastle; }
-	whiteRook() { }
+	void setCastle(bool flag) { static_assert(pieceType == ROOK || pieceType == KING, "only rooks and kings castle"); moveFlag = flag; }
+	bool getCastle() const { static_assert(pieceType == ROOK || pieceType == KING, "only rooks and kings castle"); return moveFlag; }
 };
 
 
-class whiteQueen : public whiteChessPiece
-{
-public:
-	whiteQueen(int c, int r) 
-	{ setColumn(c); setRow(r); color = WHITE; type = QUEEN; setCaptured(false); }
-
-	PIECE_TYPE getType() { return type; }
-	bool validMovement(int c, int r);
-	void moveTo(int c, int r) { setColumn(c); setRow(r); }
-	whiteQueen() { }
-};
+typedef chessPieceOf<BLACK, PAWN> blackPawn;
+typedef chessPieceOf<BLACK, KNIGHT> blackKnight;
+typedef chessPieceOf<BLACK, BISHOP> blackBishop;
+typedef chessPieceOf<BLACK, ROOK> blackRook;
+typedef chessPieceOf<BLACK, QUEEN> blackQueen;
+typedef chessPieceOf<BLACK, KING> blackKing;
 
+typedef chessPieceOf<WHITE, PAWN> whitePawn;
+typedef chessPieceOf<WHITE, KNIGHT> whiteKnight;
+typedef chessPieceOf<WHITE, BISHOP> whiteBishop;
+typedef chessPieceOf<WHITE, ROOK> whiteRook;
+typedef chessPieceOf<WHITE, QUEEN> whiteQueen;
+typedef chessPieceOf<WHITE, KING> whiteKing;
 
-class whiteKing : public whiteChessPiece
-{
-private:
-	bool canCastle;
-public:
-	whiteKing(int c, int r) : canCastle(true)
-	{ setColumn(c); setRow(r); color = WHITE; type = KING; setCaptured(false); }
-
-	PIECE_TYPE getType() { return type; }
-	bool validMovement(int c, int r);
-	void moveTo(int c, int r) { setColumn(c); setRow(r); canCastle = false; }
-	bool getCastle() { return canCastle; }
-	whiteKing() { }
-};
-
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,58 @@
+#pragma once
+
+#ifndef CHESS_PIECE_POOL_
+#define CHESS_PIECE_POOL_
+
+#include <cstddef>
+#include <new>
+
+//	====== Piece Pool Notes ======
+/*
+	chessBoardClass keeps its pieces in one pool per color and type, and board[][] points into the pools.  A
+	std::vector moves its elements when it grows, which would leave every pointer into it (in board[][], the board
+	analysis vectors, and undoInfo) pointing at freed memory.  A pool has a fixed capacity, set by the most pieces of
+	its type a side can ever have, and never moves an element.  A piece keeps its address and index for as long as it
+	is in the pool.
+
+	The interface is the part of std::vector the board uses.  Nothing is allocated, and nothing checks the capacity;
+	the board makes sure a pool is never asked to hold more than it can (see loadFEN()).
+*/
+
+template <class piece, int capacity>
+class piecePool
+{
+protected:
+	alignas(piece) unsigned char storage[capacity * sizeof(piece)];
+	int count;
+
+	piece* data() { return reinterpret_cast<piece*>(storage); }
+	const piece* data() const { return reinterpret_cast<const piece*>(storage); }
+
+public:
+	piecePool() : count(0) { }
+	~piecePool() { clear(); }
+
+	int size() const { return count; }
+	bool empty() const { return count == 0; }
+
+	piece& operator[](int i) { return data()[i]; }
+	const piece& operator[](int i) const { return data()[i]; }
+	piece& front() { return data()[0]; }
+	piece& back() { return data()[count - 1]; }
+
+	piece* begin() { return data(); }
+	piece* end() { return data() + count; }
+
+	void push_back(const piece& obj) { new (data() + count) piece(obj); ++count; }
+	void pop_back() { --count; data()[count].~piece(); }
+	void clear() { while (count > 0) pop_back(); }
+
+	//	Replaces the contents with n copies of obj.
+	void assign(int n, const piece& obj) { clear(); for (int i = 0; i < n; ++i) push_back(obj); }
+
+	//	Pools hold pieces that board[][] points at, so they are never copied as a whole.
+	piecePool(const piecePool&) = delete;
+	void operator=(const piecePool&) = delete;
+};
+
+#endif
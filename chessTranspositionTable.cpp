@@ -0,0 +1,125 @@
+#include "chessTranspositionTable.h"
+#include <climits>
+
+transpositionTable::transpositionTable(int sizeMB)
+{
+	buckets = NULL;
+	age = 0;
+
+	resize(sizeMB);
+}
+
+transpositionTable::~transpositionTable()
+{
+	delete[] buckets;
+}
+
+void transpositionTable::resize(int sizeMB)
+{
+	if (sizeMB < 1)
+		sizeMB = 1;
+
+	std::uint64_t count = 1;
+	while (count * 2 * sizeof(bucket) <= (std::uint64_t(sizeMB) << 20))
+		count *= 2;
+
+	delete[] buckets;
+	buckets = new bucket[count];
+	bucketMask = count - 1;
+
+	clear();
+}
+
+void transpositionTable::clear()
+{
+	for (std::uint64_t i = 0; i <= bucketMask; ++i)
+		for (int j = 0; j < 4; ++j)
+		{
+			buckets[i].slots[j].check.store(0, std::memory_order_relaxed);
+			buckets[i].slots[j].data.store(0, std::memory_order_relaxed);
+		}
+}
+
+std::uint64_t transpositionTable::pack(chessMove move, int score, int depth, TT_BOUND bound, int age)
+{
+	return std::uint64_t(move.data)
+		| (std::uint64_t(std::uint32_t(score)) << 16)
+		| (std::uint64_t(depth & 0xFF) << 48)
+		| (std::uint64_t(bound) << 56)
+		| (std::uint64_t(age) << 58);
+}
+
+bool transpositionTable::probe(positionKey key, ttEntry& entry, int ply)
+{
+	bucket& b = buckets[key & bucketMask];
+
+	for (int i = 0; i < 4; ++i)
+	{
+		std::uint64_t data = b.slots[i].data.load(std::memory_order_relaxed);
+		std::uint64_t check = b.slots[i].check.load(std::memory_order_relaxed);
+
+		if (data == 0 || (check ^ data) != key)
+			continue;
+
+		entry.move.data = std::uint16_t(data);
+		entry.score = int(std::uint32_t(data >> 16));
+
+		//	Stored as the distance from this position; the search wants the distance from its root.
+		if (entry.score >= MATE_BOUND)
+			entry.score -= ply;
+		else if (entry.score <= -MATE_BOUND)
+			entry.score += ply;
+		entry.depth = int((data >> 48) & 0xFF);
+		entry.bound = TT_BOUND((data >> 56) & 0x3);
+
+		return true;
+	}
+
+	return false;
+}
+
+void transpositionTable::store(positionKey key, chessMove move, int score, int depth, TT_BOUND bound, int ply)
+{
+	//	A mate is stored as the distance from this position, so that it is right wherever the position comes up again.
+	if (score >= MATE_BOUND)
+		score += ply;
+	else if (score <= -MATE_BOUND)
+		score -= ply;
+
+	bucket& b = buckets[key & bucketMask];
+
+	slot* replace = &b.slots[0];
+	int worst = INT_MAX;
+
+	for (int i = 0; i < 4; ++i)
+	{
+		std::uint64_t data = b.slots[i].data.load(std::memory_order_relaxed);
+		std::uint64_t check = b.slots[i].check.load(std::memory_order_relaxed);
+
+		//	An empty slot, or the same position:  Use it, keeping its move if there isn't a new one.
+		if (data == 0 || (check ^ data) == key)
+		{
+			if (data != 0 && move == chessMove())
+				move.data = std::uint16_t(data);
+
+			replace = &b.slots[i];
+			break;
+		}
+
+		//	Otherwise replace the shallowest slot, counting each search it has sat through as 8 plies less.
+		int entryDepth = int((data >> 48) & 0xFF);
+		int entryAge = int(data >> 58);
+		int value = entryDepth - 8 * ((age - entryAge) & 0x3F);
+
+		if (value < worst)
+		{
+			worst = value;
+			replace = &b.slots[i];
+		}
+	}
+
+	std::uint64_t data = pack(move, score, depth, bound, age);
+
+	replace->data.store(data, std::memory_order_relaxed);
+	replace->check.store(key ^ data, std::memory_order_relaxed);
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#ifndef CHESS_TRANSPOSITION_TABLE_
+#define CHESS_TRANSPOSITION_TABLE_
+
+#include "chessBoardClass.h"
+#include <atomic>
+#include <cstdint>
+
+//	====== Transposition Table Notes ======
+/*
+	The same position is often reached by different orders of the same moves (a transposition).  The table remembers,
+	by Zobrist key, what the search found out about positions it has already searched: the best move, the score, how
+	deep the search went, and whether the score is exact or only a bound.  If a position comes up again and the stored
+	search went at least as deep, the score can be used as-is.  Otherwise the stored move is still the best guess at
+	what to try first.  The table is kept from one search to the next, so most of the last move's work is reused.
+
+	Mate scores count the plies from the root of the search to the mate (see MATE), so the same position reached at a
+	different ply has a different score.  The table stores them as the distance from the position itself instead, and
+	probe() turns them back into the distance from the root of the search asking for them.
+
+	The table is a power-of-two number of buckets, and the low bits of a key pick the bucket.  A bucket holds four slots,
+	which fills a 64 byte cache line.  When a bucket is full, the slot that is least worth keeping is replaced.  That is
+	the shallowest one, with slots left over from earlier searches (see newSearch()) counting as shallower still.
+
+	Reads and writes take no locks, so that several search threads can share one table.  Each slot is two 64-bit words:
+	data, which packs everything but the key, and check, which is key ^ data.  A reader only trusts a slot if
+	check ^ data gives back its key.  If two threads write one slot at the same time, the words can end up from
+	different writes.  They then fail the test and the slot reads as empty, rather than as a wrong entry.
+*/
+
+//	Score of the side to move checkmating on the board.  A mate found ply plies from the root of the search is scored
+//	MATE - ply, and being mated -(MATE - ply), so the search prefers a shorter mate, and puts off being mated.
+const int MATE = 32000;
+
+//	Scores at least this far from 0 are mates.  Leaves room for a mate at any ply the search can reach.
+const int MATE_BOUND = MATE - 1000;
+
+//	What the score stored with a position means.  A search that cut off only knows the score is at least beta,
+//	and one that found nothing better than alpha only knows it is at most alpha.
+enum TT_BOUND { NO_BOUND, UPPER_BOUND, LOWER_BOUND, EXACT_BOUND };
+
+//	What probe() hands back for a position.
+struct ttEntry
+{
+	chessMove move;		// Best move found, or an empty chessMove if there was none.
+	int score;
+	int depth;			// Remaining depth the position was searched to.
+	TT_BOUND bound;
+};
+
+class transpositionTable
+{
+protected:
+	//	data layout:  bits 0-15 move, 16-47 score, 48-55 depth, 56-57 bound, 58-63 age.
+	struct slot
+	{
+		std::atomic<std::uint64_t> check;
+		std::atomic<std::uint64_t> data;
+	};
+
+	struct alignas(64) bucket
+	{
+		slot slots[4];
+	};
+
+	bucket* buckets;
+	std::uint64_t bucketMask;	// Number of buckets - 1.
+	int age;					// Age written into new entries.  Counts 0 - 63 and wraps.
+
+	static std::uint64_t pack(chessMove move, int score, int depth, TT_BOUND bound, int age);
+
+public:
+	//	sizeMB is the most memory the table may use, in megabytes.
+	transpositionTable(int sizeMB = 16);
+	~transpositionTable();
+
+	//	Throws away every entry and sizes the table to the largest power-of-two number of buckets that fits in sizeMB.
+	void resize(int sizeMB);
+
+	//	Throws away every entry.
+	void clear();
+
+	//	Marks the start of a new search, so that what is left over from earlier ones is replaced first.
+	void newSearch() { age = (age + 1) & 0x3F; }
+
+	//	Looks key up, filling in entry and returning true if it is in the table.  ply is how far the position is from
+	//	the root of the search, for mate scores.
+	bool probe(positionKey key, ttEntry& entry, int ply);
+
+	//	Stores what a search found out about the position key, ply plies from the root of the search.  An empty move
+	//	keeps the move already stored for it.
+	void store(positionKey key, chessMove move, int score, int depth, TT_BOUND bound, int ply);
+
+	//	Returns the size of the table in megabytes.
+	int getSizeMB() const { return int(((bucketMask + 1) * sizeof(bucket)) >> 20); }
+
+	transpositionTable(const transpositionTable&) = delete;
+	void operator=(const transpositionTable&) = delete;
+};
+
+#endif
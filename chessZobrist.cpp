@@ -0,0 +1,43 @@
+#include "chessZobrist.h"
+
+positionKey zobristPieceKeys[2][6][64];
+positionKey zobristTurnKey;
+positionKey zobristCastleKeys[16];
+positionKey zobristEnPassantKeys[64];
+
+static bool keysReady = false;
+
+//	xorshift64* pseudo-random number generator.  Quick, and more than random enough for hashing.
+static positionKey nextRandom(positionKey& state)
+{
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+
+	return state * 0x2545F4914F6CDD1Dull;
+}
+
+void initZobristKeys()
+{
+	if (keysReady)
+		return;
+
+	positionKey state = 0x9E3779B97F4A7C15ull;
+
+	for (int color = 0; color < 2; ++color)
+		for (int type = 0; type < 6; ++type)
+			for (int square = 0; square < 64; ++square)
+				zobristPieceKeys[color][type][square] = nextRandom(state);
+
+	zobristTurnKey = nextRandom(state);
+
+	//	No castling rights at all is left at 0, so a position without any doesn't need a castling number.
+	zobristCastleKeys[0] = 0;
+	for (int rights = 1; rights < 16; ++rights)
+		zobristCastleKeys[rights] = nextRandom(state);
+
+	for (int square = 0; square < 64; ++square)
+		zobristEnPassantKeys[square] = nextRandom(state);
+
+	keysReady = true;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#ifndef CHESS_ZOBRIST_
+#define CHESS_ZOBRIST_
+
+#include <cstdint>
+
+//	====== Zobrist Key Notes ======
+/*
+	A Zobrist key is a 64-bit number that stands for a whole position.  Every (color, piece type, square) is given a
+	random number, and so is black being the side to move, every combination of castling rights, and every square a
+	pawn that can be taken en passant might be standing on.  The key of a position is the numbers for everything
+	that is true about it XORed together.
+
+	XOR undoes itself, so moving a piece only takes two XORs (out of its old square, into its new one).  This lets
+	chessBoardClass keep its key up to date as moves are played, rather than working it out from scratch.  Two
+	different positions can in theory end up with the same key, but with 64 bits it's rare enough that transposition
+	tables and repetition checks can treat the key as the position.
+*/
+
+typedef std::uint64_t positionKey;
+
+//	Castling rights, as bits of an index (0 - 15) into zobristCastleKeys.
+enum CASTLE_RIGHTS { WHITE_KING_SIDE = 1, WHITE_QUEEN_SIDE = 2, BLACK_KING_SIDE = 4, BLACK_QUEEN_SIDE = 8 };
+
+extern positionKey zobristPieceKeys[2][6][64];		// Indexed by PIECE_COLOR, PIECE_TYPE, and square.
+extern positionKey zobristTurnKey;					// Included when it is black's turn.
+extern positionKey zobristCastleKeys[16];			// Indexed by a set of CASTLE_RIGHTS bits.
+extern positionKey zobristEnPassantKeys[64];		// Indexed by the square of a pawn that can be taken en passant.
+
+//	Fills in the key tables.  The numbers come from a fixed seed, so a position has the same key every time the
+//	program is run.  Safe to call more than once.
+void initZobristKeys();
+
+#endif
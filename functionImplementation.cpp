@@ -4,6 +4,7 @@
 #include "chessBoardClass.h"
 #include "chessAI.h"
 #include "GlobalVars.h"
+#include "BitmapFontClass.h"
 #include <GL/glut.h>
 
 #include <iostream>
@@ -0,0 +1,322 @@
+/*	====================================================================================================================
+	Headless UCI front end.
+
+	Builds a console program that speaks the Universal Chess Interface, so the engine can be run by chess GUIs, match
+	runners, and analysis tools without a display.  It is built from the engine sources alone (chessBitboard,
+	chessBoardClass, chessEvaluationTables, chessGameTree, chessPerft, chessPieceClasses, chessTranspositionTable,
+	chessZobrist, and this file); main.cpp, functionImplementation.cpp, and BitmapFontClass.cpp, which need OpenGL and GLUT, are
+	left out.
+
+	Commands understood:
+
+		uci, isready, ucinewgame, quit
+		setoption name Hash value <MB>
+		setoption name Threads value <count>
+		setoption name PerftHash value <MB>		(0 turns the perft table off)
+		position [startpos | fen <fen>] [moves <move> ...]
+		go [depth <n>] [movetime <ms>] [wtime <ms>] [btime <ms>] [winc <ms>] [binc <ms>] [movestogo <n>] [nodes <n>] [infinite]
+		stop
+
+	and, for testing move generation:
+
+		go perft <depth>		Counts the moves under each legal move of the current position (divide).
+		perft [<depth>]			Checks the reference positions in chessPerft.cpp, to at most depth (default 6).
+
+	Both use as many threads as the Threads option.
+
+	The search runs on its own thread, so that stop can be read while it is going.
+	====================================================================================================================
+*/
+
+#include "chessGameTree.h"
+#include "chessPerft.h"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <climits>
+
+static std::mutex outputLock;	// Keeps lines written by the search thread and the command loop from running together.
+
+static std::mutex stopLock;						// Guards stopReceived.
+static std::condition_variable stopSignal;		// Wakes a finished go infinite up once stopReceived is set.
+static bool stopReceived = false;				// Set when the GUI sends stop (or quit) for the search that is running.
+
+//	Writes one line to the GUI.
+static void sendLine(const std::string& line)
+{
+	std::lock_guard<std::mutex> guard(outputLock);
+	std::cout << line << std::endl;
+}
+
+//	Returns the legal move of board written as text, or an empty move if there is no such move.
+static chessMove stringToMove(chessBoardClass& board, const std::string& text)
+{
+	moveList moves;
+	board.generateMoves(moves);
+
+	for (int i = 0; i < moves.size(); ++i)
+		if (moves[i].toString() == text)
+			return moves[i];
+
+	return chessMove();
+}
+
+//	The game tree, with each finished iteration reported to the GUI as an info line.
+class uciGameTree : public chessGameTree
+{
+protected:
+	chessMove bestMove;		// Best move of the last iteration to finish.
+
+	void reportIteration(int depth, int score, chessMove move, std::uint64_t nodes, long long elapsed)
+	{
+		bestMove = move;
+
+		//	No rate can be worked out before a millisecond has passed.
+		long long nps = (elapsed > 0) ? (long long)(nodes * 1000 / elapsed) : 0;
+
+		std::ostringstream line;
+		line << "info depth " << depth;
+
+		//	A mate goes out as the number of moves (not plies) to it, negative if the side to move is the one being mated.
+		if (score >= MATE_BOUND)
+			line << " score mate " << (MATE - score + 1) / 2;
+		else if (score <= -MATE_BOUND)
+			line << " score mate " << -((MATE + score + 1) / 2);
+		else
+			line << " score cp " << score;
+
+		line << " nodes " << nodes << " nps " << nps << " time " << elapsed;
+
+		//	A side that is checkmated or stalemated has no move to show.
+		if (move != chessMove())
+			line << " pv " << move.toString();
+
+		sendLine(line.str());
+	}
+
+public:
+	uciGameTree(chessBoardClass& board) : chessGameTree(board) { }
+
+	void clearBestMove() { bestMove = chessMove(); }
+	chessMove getBestMove() const { return bestMove; }
+};
+
+//	Runs on the search thread.
+static void runSearch(uciGameTree* tree, searchLimits limits)
+{
+	tree->clearBestMove();
+	tree->findBestMove(limits);
+
+	//	go infinite may only answer with bestmove once the GUI has said stop, even if the search ran out of depth first.
+	if (limits.infinite)
+	{
+		std::unique_lock<std::mutex> guard(stopLock);
+		stopSignal.wait(guard, [] { return stopReceived; });
+	}
+
+	chessMove move = tree->getBestMove();
+	sendLine("bestmove " + (move == chessMove() ? std::string("0000") : move.toString()));
+}
+
+//	Stops the search running on search, if there is one, and waits for it to send its bestmove.
+static void stopSearch(uciGameTree& tree, std::thread& search)
+{
+	if (!search.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> guard(stopLock);
+		stopReceived = true;
+	}
+	stopSignal.notify_all();
+
+	tree.requestStop();
+	search.join();
+}
+
+//	Sets board up from a position command:  position [startpos | fen <fen>] [moves <move> ...]
+static void setPosition(chessBoardClass& board, const chessBoardClass& startPosition, std::istringstream& input)
+{
+	std::string token;
+	input >> token;
+
+	board = startPosition;
+
+	if (token == "fen")
+	{
+		//	The fen string runs up to the move list, if there is one.
+		std::string fen;
+		while (input >> token && token != "moves")
+			fen += (fen.empty() ? "" : " ") + token;
+
+		if (!board.loadFEN(fen))
+		{
+			sendLine("info string illegal fen " + fen);
+			return;
+		}
+	}
+	else
+		input >> token;
+
+	if (token != "moves")
+		return;
+
+	while (input >> token)
+	{
+		chessMove move = stringToMove(board, token);
+
+		if (move == chessMove())
+		{
+			sendLine("info string illegal move " + token);
+			return;
+		}
+
+		undoInfo undo;
+		board.makeMove(move, undo);
+	}
+}
+
+//	Reads the limits of a go command:  go [depth <n>] [movetime <ms>] [wtime <ms>] ... [infinite]
+static searchLimits readLimits(PIECE_COLOR turn, std::istringstream& input)
+{
+	searchLimits limits;
+	std::string token;
+
+	while (input >> token)
+	{
+		if (token == "depth")
+			input >> limits.depth;
+		else if (token == "movetime")
+			input >> limits.moveTime;
+		else if (token == "nodes")
+			input >> limits.nodes;
+		else if (token == "movestogo")
+			input >> limits.movesToGo;
+		else if (token == "infinite")
+			limits.infinite = true;
+		else if ((token == "wtime" && turn == WHITE) || (token == "btime" && turn == BLACK))
+			input >> limits.timeLeft;
+		else if ((token == "winc" && turn == WHITE) || (token == "binc" && turn == BLACK))
+			input >> limits.increment;
+		else if (token == "wtime" || token == "btime" || token == "winc" || token == "binc")
+			input >> token;		// The other side's clock.
+	}
+
+	return limits;
+}
+
+int main()
+{
+	//	A board set by assignment is marked as owned by the AI, so it never stops to ask which piece to promote to.
+	chessBoardClass startPosition;
+	startPosition.init();
+
+	chessBoardClass board;
+	board.init();
+	board = startPosition;
+
+	uciGameTree tree(board);
+	std::thread search;
+
+	perftTable perftHash(1);
+	int perftHashMB = 0;
+	int threadCount = 1;
+
+	std::string line;
+
+	while (std::getline(std::cin, line))
+	{
+		std::istringstream input(line);
+		std::string command;
+		input >> command;
+
+		if (command == "uci")
+		{
+			sendLine("id name Chess_Program");
+			sendLine("id author Thomas Ferguson");
+			sendLine("option name Hash type spin default 16 min 1 max 4096");
+			sendLine("option name Threads type spin default 1 min 1 max 256");
+			sendLine("option name PerftHash type spin default 0 min 0 max 4096");
+			sendLine("uciok");
+		}
+		else if (command == "isready")
+			sendLine("readyok");
+		else if (command == "setoption")
+		{
+			//	setoption name <name> value <value>
+			std::string token, name;
+			int value = 0;
+
+			input >> token >> name >> token >> value;
+
+			if (name == "Hash")
+				tree.setHashSize(std::max(value, 1));
+			else if (name == "Threads")
+			{
+				threadCount = std::max(value, 1);
+				tree.setThreadCount(threadCount);
+			}
+			else if (name == "PerftHash")
+			{
+				perftHashMB = std::max(value, 0);
+				perftHash.resize(perftHashMB);
+			}
+		}
+		else if (command == "ucinewgame")
+			tree.clearHash();
+		else if (command == "position")
+			setPosition(board, startPosition, input);
+		else if (command == "go" && line.find("perft") != std::string::npos)
+		{
+			//	go perft <depth>
+			std::string token;
+			int depth = 1;
+			input >> token >> depth;
+
+			stopSearch(tree, search);
+
+			perftHash.clear();
+
+			std::lock_guard<std::mutex> guard(outputLock);
+			perftDivide(board, depth, std::cout, (perftHashMB > 0) ? &perftHash : NULL, threadCount);
+		}
+		else if (command == "perft")
+		{
+			//	perft [<depth>]
+			int depth = 6;
+			input >> depth;
+
+			stopSearch(tree, search);
+
+			perftHash.clear();
+
+			std::lock_guard<std::mutex> guard(outputLock);
+			perftSuite(depth, std::cout, (perftHashMB > 0) ? &perftHash : NULL, threadCount);
+		}
+		else if (command == "go")
+		{
+			stopSearch(tree, search);
+
+			tree.setGameState(board);
+			tree.requestStop(false);
+
+			{
+				std::lock_guard<std::mutex> guard(stopLock);
+				stopReceived = false;
+			}
+
+			search = std::thread(runSearch, &tree, readLimits(board.getTurn(), input));
+		}
+		else if (command == "stop")
+			stopSearch(tree, search);
+		else if (command == "quit")
+			break;
+	}
+
+	stopSearch(tree, search);
+
+	return 0;
+}